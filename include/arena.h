@@ -0,0 +1,22 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include "structs.h"
+#include "error.h"
+
+#define ARENA_ALIGNMENT 16
+
+int init_arena(arena_t*, size_t);
+int arena_alloc(arena_t*, size_t, void**);
+size_t arena_mark(const arena_t*);
+void arena_reset(arena_t*, size_t);
+void free_arena(arena_t*);
+
+#endif /* !ARENA_H_ */
@@ -0,0 +1,36 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef BLUE_NOISE_H_
+#define BLUE_NOISE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "random.h"
+
+#define BLUE_NOISE_SIZE 256
+#define BLUE_NOISE_SIGMA 1.5
+#define BLUE_NOISE_RADIUS 8
+#define BLUE_NOISE_BLOCK 16
+#define BLUE_NOISE_FRACTION 0.1f
+#define BLUE_NOISE_SEED 0x1b873593u
+#define BLUE_NOISE_VERSION 1
+#define BLUE_NOISE_CACHE_DIR "cache"
+#define BLUE_NOISE_MAGIC 0x4e424750u
+
+int generate_blue_noise(int, uint8_t**);
+int load_blue_noise(int, GLuint*);
+
+#endif /* !BLUE_NOISE_H_ */
@@ -8,11 +8,17 @@
 #include <stdio.h>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "structs.h"
+
+// seconds without input before the view is considered idle
+#define INTERACTION_IDLE_DELAY 0.25
 
 void framebuffer_size_callback(GLFWwindow*, int, int);
 void error_callback(int, const char*);
 void scroll_callback(GLFWwindow*, double, double);
 void mouse_button_callback(GLFWwindow*, int, int, int);
 void cursor_position_callback(GLFWwindow*, double, double);
+void key_callback(GLFWwindow*, int, int, int, int);
+int is_interacting(const state_t*);
 
 #endif /* !CALLBACKS_H_ */
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef CANOPY_H_
+#define CANOPY_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "shaders.h"
+#include "segments.h"
+
+#define CANOPY_MIN_DEPTH 1
+#define CANOPY_MAX_DEPTH 20
+#define CANOPY_ANGLE_STEP (M_PI / 60.0f)
+#define CANOPY_GRID_CELLS_PER_SEGMENT 1.0f
+#define CANOPY_GRID_MAX_DIM 2048
+#define CANOPY_TRUNK_X 0.0f
+#define CANOPY_TRUNK_Y -0.8f
+#define CANOPY_SWAY 0.08f
+
+void init_canopy_params(canopy_params_t*);
+int init_canopy(canopy_t*);
+int generate_canopy_segments(const canopy_params_t*, float**, int*);
+int update_canopy(canopy_t*, const canopy_params_t*);
+void set_canopy_uniforms(canopy_t*, const canopy_params_t*, GLuint);
+void draw_canopy_segments(canopy_t*, const canopy_params_t*, int, int);
+int draw_animated_canopy(canopy_t*, const canopy_params_t*, float, int, int);
+void free_canopy(canopy_t*);
+
+#endif /* !CANOPY_H_ */
@@ -0,0 +1,20 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef CHECKERBOARD_H_
+#define CHECKERBOARD_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+int init_checkerboard(checkerboard_t*);
+int begin_checkerboard(checkerboard_t*, int, int);
+int resolve_checkerboard(checkerboard_t*, state_t*, int, int, GLuint, int, GLuint*);
+void reset_checkerboard(checkerboard_t*);
+void free_checkerboard(checkerboard_t*);
+
+#endif /* !CHECKERBOARD_H_ */
@@ -0,0 +1,42 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef COLONIZATION_H_
+#define COLONIZATION_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "random.h"
+#include "segments.h"
+#include "canopy.h"
+
+#define COLONIZATION_POINTS 200000
+#define COLONIZATION_MAX_NODES (1 << 20)
+#define COLONIZATION_MAX_ITERATIONS 4096
+#define COLONIZATION_THREADS 8
+#define COLONIZATION_INFLUENCE 0.06f
+#define COLONIZATION_KILL 0.003f
+#define COLONIZATION_STEP 0.002f
+#define COLONIZATION_SAME_DIRECTION 0.9999f
+#define COLONIZATION_THICKNESS 0.0008f
+#define COLONIZATION_EXTENT 1.0f
+#define COLONIZATION_CROWN_Y 0.2f
+#define COLONIZATION_CROWN_RX 0.75f
+#define COLONIZATION_CROWN_RY 0.55f
+#define COLONIZATION_SEED 0x2545f491u
+
+int search_nearest_nodes(const float*, int, const float*, int, int, int*);
+int init_colonization(colonization_t*);
+void draw_colonization(colonization_t*, GLuint, int, int);
+void free_colonization(colonization_t*);
+
+#endif /* !COLONIZATION_H_ */
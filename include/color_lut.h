@@ -0,0 +1,22 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef COLOR_LUT_H_
+#define COLOR_LUT_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define COLOR_LUT_SIZE 65
+#define COLOR_LUT_UNIT (RENDER_GRAPH_MAX_INPUTS + 1)
+
+int init_color_lut(color_lut_t*, int);
+int update_color_lut(color_lut_t*, int, int);
+void bind_color_lut(const color_lut_t*, GLuint);
+void free_color_lut(color_lut_t*);
+
+#endif /* !COLOR_LUT_H_ */
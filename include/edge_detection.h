@@ -0,0 +1,31 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef EDGE_DETECTION_H_
+#define EDGE_DETECTION_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define EDGE_TILE_SIZE 16       // local size of compute_edge.comp
+#define EDGE_SCALE 0.25f        // same as edge_detection.glsl, a full black to white step gives 1
+
+// The AVX2 twin is built for any x86 GCC or Clang and chosen at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EDGE_DETECTION_AVX2
+#endif
+
+int init_edge_detection(edge_detection_t*);
+int detect_edges(edge_detection_t*, GLuint, int, int, GLuint*);
+int detect_edges_cpu(const uint8_t*, int, int, int, uint8_t*);
+int upload_edges(edge_detection_t*, const uint8_t*, int, int, int);
+void free_edge_detection(edge_detection_t*);
+
+#endif /* !EDGE_DETECTION_H_ */
@@ -0,0 +1,30 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef ERROR_DIFFUSION_H_
+#define ERROR_DIFFUSION_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <pthread.h>
+#include "structs.h"
+#include "error.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define DIFFUSION_THREADS 8
+#define DIFFUSION_REACH 2
+#define DIFFUSION_PUBLISH_STEP 16
+
+int parse_diffusion_kernel(const char*, int*);
+int diffuse_error(uint8_t*, int, int, int, int, int);
+int diffuse_error_serial(uint8_t*, int, int, int, int, int);
+
+#endif /* !ERROR_DIFFUSION_H_ */
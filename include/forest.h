@@ -0,0 +1,35 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef FOREST_H_
+#define FOREST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "canopy.h"
+#include "random.h"
+
+#define FOREST_TREES 20000
+#define FOREST_WORLD_WIDTH 512.0f
+#define FOREST_WORLD_HEIGHT 128.0f
+#define FOREST_TILE_SIZE 8.0f
+#define FOREST_DEPTH 9
+#define FOREST_MIN_SCALE 0.5f
+#define FOREST_MAX_SCALE 1.5f
+#define FOREST_THICKNESS 0.004f
+#define FOREST_ZOOM 0.05f
+#define FOREST_SEED 0x9e3779b9u
+
+int init_forest(forest_t*, state_t*);
+void draw_forest(forest_t*, GLuint, const state_t*, int, int);
+void free_forest(forest_t*);
+
+#endif /* !FOREST_H_ */
@@ -0,0 +1,19 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef FRAMEBUFFER_H_
+#define FRAMEBUFFER_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+int resize_render_target(render_target_t*, int, int, GLenum);
+void bind_render_target(render_target_t*);
+void unbind_render_target(int, int);
+void delete_render_target(render_target_t*);
+
+#endif /* !FRAMEBUFFER_H_ */
@@ -0,0 +1,30 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef GRADIENT_H_
+#define GRADIENT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define GRADIENT_DEFAULT_PATH "palettes/gradients.txt"
+#define GRADIENT_WIDTH 256
+#define GRADIENT_MAX_STOPS 16
+#define GRADIENT_MAX_LINE 128
+#define GRADIENT_GAMMA 2.2
+#define GRADIENT_UNIT 3
+
+int init_gradient(gradient_t*);
+void bind_gradient(gradient_t*, int, GLuint);
+void free_gradient(gradient_t*);
+
+#endif /* !GRADIENT_H_ */
@@ -12,6 +12,7 @@
 #include "error.h"
 #include "../stb/include/stb_image.h"
 
+int load_image(const char*, image_t*, state_t*);
 int init(int, int, data_t*);
 
 #endif /* !INIT_H_ */
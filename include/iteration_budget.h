@@ -0,0 +1,29 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef ITERATION_BUDGET_H_
+#define ITERATION_BUDGET_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define BUDGET_BASE_ITERATIONS 1000.0f
+#define BUDGET_DEFAULT_FRACTION 0.995f
+#define BUDGET_PROBE_WIDTH 64
+#define BUDGET_PROBE_FACTOR 4.0f
+#define BUDGET_MARGIN 1.25f
+#define BUDGET_MIN_ITERATIONS 64.0f
+#define BUDGET_REPORT_CHANGE 0.05f
+
+int init_iteration_budget(iteration_budget_t*);
+int update_iteration_budget(iteration_budget_t*, state_t*, GLuint, GLuint);
+void free_iteration_budget(iteration_budget_t*);
+
+#endif /* !ITERATION_BUDGET_H_ */
@@ -0,0 +1,27 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef JUMP_FLOOD_H_
+#define JUMP_FLOOD_H_
+
+#include <stdio.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define JUMP_FLOOD_SEED_THRESHOLD 0.25f
+#define JUMP_FLOOD_EFFECT_WIDTH 6.0f
+#define JUMP_FLOOD_GLOW_REACH 4.0f
+
+int init_jump_flood(jump_flood_t*);
+int begin_jump_flood_seeds(jump_flood_t*, int, int, GLenum);
+int seed_jump_flood(jump_flood_t*, GLuint, float, int, int, GLuint);
+void run_jump_flood(jump_flood_t*, GLuint, int, GLuint, GLuint*);
+int apply_distance_effect(jump_flood_t*, int, float, GLuint, int, int, GLuint, GLuint*);
+const char* distance_effect_name(int);
+void free_jump_flood(jump_flood_t*);
+
+#endif /* !JUMP_FLOOD_H_ */
@@ -0,0 +1,35 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef LSYSTEM_H_
+#define LSYSTEM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "arena.h"
+#include "segments.h"
+
+#define LSYSTEM_ARENA_SIZE (1 << 20)
+#define LSYSTEM_MAX_LINE 4096
+#define LSYSTEM_MAX_ITERATIONS 64
+#define LSYSTEM_MAX_NESTING 4096
+#define LSYSTEM_MAX_SEGMENTS (1 << 25)
+#define LSYSTEM_DEFAULT_ANGLE 25.0f
+#define LSYSTEM_DEFAULT_ITERATIONS 4
+#define LSYSTEM_DEFAULT_THICKNESS 0.002f
+#define LSYSTEM_FIT 1.8f
+
+int init_lsystem(lsystem_t*, const char*);
+void draw_lsystem(lsystem_t*, GLuint, int, int);
+void free_lsystem(lsystem_t*);
+
+#endif /* !LSYSTEM_H_ */
@@ -0,0 +1,21 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef MANDELBROT_COMPUTE_H_
+#define MANDELBROT_COMPUTE_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define COMPUTE_TILE_SIZE 8
+#define COMPUTE_PERSISTENT_GROUPS 256
+
+int init_mandelbrot_compute(mandelbrot_compute_t*);
+int dispatch_mandelbrot_compute(mandelbrot_compute_t*, state_t*, iteration_budget_t*, int, int, float, const mirror_band_t*);
+void free_mandelbrot_compute(mandelbrot_compute_t*);
+
+#endif /* !MANDELBROT_COMPUTE_H_ */
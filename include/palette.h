@@ -0,0 +1,31 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef PALETTE_H_
+#define PALETTE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "structs.h"
+#include "error.h"
+#include "random.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define PALETTE_MAX_COLORS 256
+#define PALETTE_THREADS 8
+#define PALETTE_ITERATIONS 16
+#define PALETTE_TOLERANCE 0.25f
+#define PALETTE_SEED 0x85ebca6bu
+
+int fit_palette(const uint8_t*, int, int, int, int, uint8_t*, int*, uint8_t*);
+int quantize_palette(const uint8_t*, int, int, int, uint8_t*, int*, uint8_t*);
+
+#endif /* !PALETTE_H_ */
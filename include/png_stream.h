@@ -0,0 +1,26 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef PNG_STREAM_H_
+#define PNG_STREAM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+#include <png.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define PNG_STREAM_CHUNK 65536          // bytes of the file handed to libpng at once
+#define PNG_STREAM_BAND (1 << 22)       // bytes of rows decoded into a pixel buffer before its upload
+#define PNG_STREAM_BUFFERS 2            // one band uploads while the next one decodes
+
+int can_stream_png(const char*);
+int stream_png_texture(const char*, image_t*, GLuint*);
+
+#endif /* !PNG_STREAM_H_ */
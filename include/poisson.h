@@ -0,0 +1,36 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef POISSON_H_
+#define POISSON_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "random.h"
+#include "init.h"
+
+#define POISSON_DEFAULT_RADIUS 0.01f
+#define POISSON_DEFAULT_DOMAIN 4.0f
+#define POISSON_RADIUS_RATIO 4.0f
+#define POISSON_CANDIDATES 30
+#define POISSON_SEEDS 16
+#define POISSON_TILE_CELLS 64
+#define POISSON_THREADS 8
+#define POISSON_DOT_SCALE 0.3f
+#define POISSON_SEED 0x6c8e9cf5u
+
+int sample_poisson(float, float, const image_t*, int, int, float**, int*);
+int init_poisson(poisson_t*, const char*, state_t*);
+void draw_poisson(poisson_t*, GLuint, const state_t*, int, int);
+void free_poisson(poisson_t*);
+
+#endif /* !POISSON_H_ */
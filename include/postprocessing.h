@@ -0,0 +1,26 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef POSTPROCESSING_H_
+#define POSTPROCESSING_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define POSTPROCESSING_DITHERING_PATTERN 0
+#define POSTPROCESSING_DITHERING_STRENGTH 0.2f
+#define POSTPROCESSING_QUANTIZATION_METHOD 2
+#define POSTPROCESSING_QUANTIZATION_LEVELS 8
+
+int init_postprocessing(postprocessing_t*);
+int prepare_postprocessing(postprocessing_t*);
+void set_postprocessing_uniforms(GLuint, const void*);
+int add_postprocessing_pass(postprocessing_t*, render_graph_t*, int, int, int, int, int*);
+int run_postprocessing(postprocessing_t*, render_graph_t*, const dynres_t*, const state_t*, int, int, GLuint, GLuint*);
+void free_postprocessing(postprocessing_t*);
+
+#endif /* !POSTPROCESSING_H_ */
@@ -0,0 +1,13 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+
+float random_float(uint32_t*);
+float random_range(uint32_t*, float, float);
+
+#endif /* !RANDOM_H_ */
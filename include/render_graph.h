@@ -0,0 +1,20 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef RENDER_GRAPH_H_
+#define RENDER_GRAPH_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+void begin_render_graph(render_graph_t*);
+int import_render_texture(render_graph_t*, GLuint, int*);
+int add_render_pass(render_graph_t*, const render_pass_t*, int*);
+int execute_render_graph(render_graph_t*, int, GLuint, GLuint*);
+void free_render_graph(render_graph_t*);
+
+#endif /* !RENDER_GRAPH_H_ */
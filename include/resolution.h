@@ -0,0 +1,26 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef RESOLUTION_H_
+#define RESOLUTION_H_
+
+#include <stdio.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define DYNRES_DEFAULT_TARGET_MS 16.6f
+#define DYNRES_DEFAULT_MIN_SCALE 0.25f
+#define DYNRES_DAMPING 0.5f
+#define DYNRES_SMOOTHING 0.2f
+#define DYNRES_SCALE_STEP 0.125f
+
+int init_dynamic_resolution(dynres_t*);
+int begin_dynamic_resolution(dynres_t*, state_t*, int*, int*);
+int end_dynamic_resolution(dynres_t*, state_t*, GLuint, GLuint);
+void free_dynamic_resolution(dynres_t*);
+
+#endif /* !RESOLUTION_H_ */
@@ -12,6 +12,8 @@
 #include <GLFW/glfw3.h>
 #include "structs.h"
 #include "error.h"
+#include "error_diffusion.h"
+#include "palette.h"
 
 int save_png(const char*, data_t*);
 
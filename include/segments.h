@@ -0,0 +1,18 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef SEGMENTS_H_
+#define SEGMENTS_H_
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+int init_segment_renderer(segment_renderer_t*, GLuint);
+void draw_segments(segment_renderer_t*, GLuint, GLsizei, float, const float*, int, int);
+void free_segment_renderer(segment_renderer_t*);
+
+#endif /* !SEGMENTS_H_ */
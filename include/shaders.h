@@ -13,6 +13,9 @@
 #include "structs.h"
 #include "shaders_preprocessing.h"
 
+int create_program(const char*, const char*, GLuint*);
+int create_feedback_program(const char*, const char*, GLuint*);
+int create_compute_program(const char*, GLuint*);
 int create_shader_program(data_t*);
 
 #endif /* !SHADERS_H_ */
\ No newline at end of file
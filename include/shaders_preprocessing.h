@@ -12,6 +12,7 @@
 #include "error.h"
 #include "structs.h"
 
+int create_shader_preprocessed(const char*, GLenum, GLuint*);
 int create_shader_fragment(const char*, GLuint*);
 
 #endif /* !SHADERS_PREPROCESSING_H_ */
\ No newline at end of file
@@ -24,10 +24,53 @@
 #define MAX_VERTEX_BUFFER 512 * 1024
 #define MAX_ELEMENT_BUFFER 128 * 1024
 
+#define DYNRES_QUERY_COUNT 4
+#define BUDGET_TILES_X 8
+#define BUDGET_TILES_Y 6
+#define LSYSTEM_SYMBOLS 256
+#define FOREST_TEMPLATES 16
+#define RENDER_GRAPH_MAX_PASSES 8
+#define RENDER_GRAPH_MAX_RESOURCES 16
+#define RENDER_GRAPH_MAX_INPUTS 4
+#define RENDER_GRAPH_POOL_SIZE 4
+#define GRADIENT_MAX 32
+#define GRADIENT_NAME_LENGTH 32
+#define VIRTUAL_TEXTURE_MAX_LEVELS 24
+#define VIRTUAL_TEXTURE_PATH_LENGTH 64
+
 typedef struct image_s image_t;
+typedef struct render_target_s render_target_t;
+typedef struct dynres_s dynres_t;
+typedef struct checkerboard_s checkerboard_t;
+typedef struct iteration_budget_s iteration_budget_t;
+typedef struct mirror_band_s mirror_band_t;
+typedef struct mandelbrot_compute_s mandelbrot_compute_t;
+typedef struct canopy_params_s canopy_params_t;
+typedef struct arena_s arena_t;
+typedef struct segment_renderer_s segment_renderer_t;
+typedef struct canopy_s canopy_t;
+typedef struct lsystem_s lsystem_t;
+typedef struct forest_s forest_t;
+typedef struct colonization_s colonization_t;
+typedef struct poisson_s poisson_t;
+typedef struct jump_flood_s jump_flood_t;
+typedef struct voronoi_s voronoi_t;
+typedef struct render_pass_s render_pass_t;
+typedef struct render_resource_s render_resource_t;
+typedef struct render_graph_s render_graph_t;
+typedef struct color_lut_s color_lut_t;
+typedef struct gradient_s gradient_t;
+typedef struct edge_detection_s edge_detection_t;
+typedef struct postprocessing_s postprocessing_t;
+typedef struct tiled_image_s tiled_image_t;
+typedef struct row_reader_s row_reader_t;
+typedef struct page_loader_s page_loader_t;
+typedef struct virtual_texture_s virtual_texture_t;
 typedef struct state_s state_t;
 typedef struct data_s data_t;
 
+typedef void (*render_pass_setup_t)(GLuint, const void*);
+
 typedef enum GENERATION_TYPE
 {
     PROCEDURAL,
@@ -38,8 +81,33 @@ typedef enum PROCEDURAL_TYPE
 {
     MANDELBROT,
     CANOPY,
+    LSYSTEM,
+    FOREST,
+    COLONIZATION,
+    POISSON,
+    VORONOI,
 } PROCEDURAL_TYPE;
 
+// screen space effects built on the distance to the drawn shapes
+typedef enum DISTANCE_EFFECT
+{
+    EFFECT_NONE,
+    EFFECT_OUTLINE,
+    EFFECT_GLOW,
+    EFFECT_STROKE,
+    EFFECT_COUNT,
+} DISTANCE_EFFECT;
+
+// CPU error diffusion kernels applied to exported images
+typedef enum DIFFUSION_KERNEL
+{
+    DIFFUSION_NONE,
+    DIFFUSION_FLOYD_STEINBERG,
+    DIFFUSION_JARVIS,
+    DIFFUSION_STUCKI,
+    DIFFUSION_ATKINSON,
+} DIFFUSION_KERNEL;
+
 struct image_s
 {
     unsigned char* buf;
@@ -48,6 +116,362 @@ struct image_s
     GLenum format;
 };
 
+struct render_target_s
+{
+    GLuint fbo;
+    GLuint texture;
+    int width;
+    int height;
+    GLenum format;
+};
+
+// dynamic resolution scaling of procedural generators
+struct dynres_s
+{
+    float scale;
+    float render_scale;         // scale snapped to DYNRES_SCALE_STEP, the render size only follows it
+    float min_scale;
+    float target_ms;
+    float gpu_ms;
+    GLuint queries[DYNRES_QUERY_COUNT];
+    float query_scale[DYNRES_QUERY_COUNT];
+    int query_pending[DYNRES_QUERY_COUNT];
+    int query_index;
+    int timing;
+    GLuint upscale_program;
+    render_target_t target;
+};
+
+// checkerboard rendering while the view moves
+struct checkerboard_s
+{
+    int parity;
+    int current;
+    int history_valid;
+    float zoom;
+    float offset[2];
+    GLuint resolve_program;
+    render_target_t half;
+    render_target_t history[2];
+};
+
+// Mandelbrot iteration budget chosen from a sparse probe of escape counts
+struct iteration_budget_s
+{
+    int per_tile;
+    float fraction;
+    float iterations;
+    float reported;
+    float probe_cap;
+    float probe_view[4];
+    float tile_iterations[BUDGET_TILES_X * BUDGET_TILES_Y];
+    GLuint pbo;
+    GLsync fence;
+    GLuint tile_texture;
+    render_target_t probe;
+};
+
+// rows of a Mandelbrot render mirrored across the real axis
+struct mirror_band_s
+{
+    float offset_y;
+    int render_y0;
+    int render_y1;
+    int src_y0;
+    int src_y1;
+    int dst_y0;
+    int dst_y1;
+};
+
+// persistent threads compute backend of the Mandelbrot generator
+struct mandelbrot_compute_s
+{
+    int available;
+    GLuint program;
+    GLuint queue;
+    render_target_t target;
+};
+
+struct canopy_params_s
+{
+    float thickness;
+    float branch_angle;
+    float branch_length;
+    float decay;
+    int depth;
+};
+
+// linear allocator, everything is released at once by resetting it to a mark
+struct arena_s
+{
+    unsigned char* base;
+    size_t size;
+    size_t used;
+};
+
+// instanced quads drawing a buffer of start.xy end.xy segments
+struct segment_renderer_s
+{
+    GLuint vao;
+    GLuint quad;
+};
+
+// canopy branch segments generated on the CPU, as start.xy end.xy,
+// binned in a uniform grid whose cells list the segments they may touch
+struct canopy_s
+{
+    canopy_params_t params;
+    float* segments;
+    int segment_count;
+    GLuint buffer;
+    GLuint texture;
+
+    float grid_thickness;
+    float grid_origin[2];
+    float grid_cell_size;
+    int grid_dims[2];
+    GLuint cell_buffer;
+    GLuint cell_texture;
+    GLuint index_buffer;
+    GLuint index_texture;
+
+    // rasterized path, one oriented quad per branch
+    GLuint raster_program;
+    segment_renderer_t raster;
+
+    // animated branches derived level by level on the GPU with transform feedback,
+    // each level is captured in the scratch buffer then copied after its parents
+    GLuint feedback_program;
+    GLuint feedback_vao;
+    GLuint animated_buffer;
+    GLuint feedback_buffer;
+    int animated_depth;
+    segment_renderer_t animated;
+};
+
+// L-system grammar read from a file, the axiom and the rules live in the arena.
+// Segments are generated once into a vertex buffer, in turtle coordinates.
+struct lsystem_s
+{
+    arena_t arena;
+    const char* axiom;
+    const char* rules[LSYSTEM_SYMBOLS];
+    int iterations;
+    float angle;
+    float thickness;
+
+    GLuint buffer;
+    GLsizei segment_count;
+    float transform[4];
+    segment_renderer_t renderer;
+};
+
+// Canopy trees scattered over a large world. A few template trees hold the geometry,
+// trees are sorted by world tile so only the tiles in view are culled each frame.
+struct forest_s
+{
+    int template_start[FOREST_TEMPLATES];
+    int template_count[FOREST_TEMPLATES];
+    float template_bounds[FOREST_TEMPLATES][4];
+    GLuint segment_buffer;
+    GLuint segment_texture;
+
+    int tree_count;
+    float* trees;               // position.xy, scale, flip
+    int* tree_template;
+    int* tile_start;            // trees of tile t are tile_start[t] to tile_start[t + 1]
+    int tiles[2];
+    float reach;                // furthest any tree extends from its base
+
+    float* visible;
+    int* visible_trees;
+    int visible_start[FOREST_TEMPLATES];
+    int visible_count[FOREST_TEMPLATES];
+    float view[4];
+    GLuint instance_buffer;
+    GLuint instance_texture;
+    GLuint vao;
+};
+
+// Tree grown by space colonization on the CPU, one segment per node to its parent
+struct colonization_s
+{
+    GLuint buffer;
+    GLsizei segment_count;
+    segment_renderer_t renderer;
+};
+
+// Poisson disk points, optionally denser where a density image is darker
+struct poisson_s
+{
+    float radius;               // smallest distance between two points
+    float domain;               // side of the square domain centered on the origin
+    int tiled;                  // fill tiles in parallel, for large domains
+    GLsizei point_count;
+    GLuint buffer;              // position.xy radius of every point
+    GLuint vao;
+    GLuint quad;
+};
+
+// Jump flooding of seed pixels, every pixel of a field holds its nearest seed, as pixel
+// coordinates or as an index given by the caller, or -1 when no seed lies within the reach
+struct jump_flood_s
+{
+    GLuint seed_program;
+    GLuint step_program;
+    GLuint effect_program;
+    int current;
+    int pair;                   // pair being flooded, 0 for GL_RG32F fields and 1 for GL_RG32I
+    render_target_t field[2][2];    // a pair per format, Voronoi and the distance effect keep theirs
+    render_target_t output;
+};
+
+// Voronoi diagram of random seeds, flooded on the GPU every frame.
+// The seed index of the two nearest seeds of every pixel gives F1 and F2.
+struct voronoi_s
+{
+    int seed_count;
+    GLuint buffer;              // position.xy of every seed
+    GLuint texture;
+    GLuint vao;
+    GLuint seed_program;
+    GLuint step_program;
+};
+
+// Full screen pass of a render graph. Inputs are bound to the given samplers,
+// the output is a target of the pool sized width x height, the graph sets the
+// resolution uniform to that size and setup sets the others.
+struct render_pass_s
+{
+    GLuint program;
+    int input_count;
+    int inputs[RENDER_GRAPH_MAX_INPUTS];
+    const char* samplers[RENDER_GRAPH_MAX_INPUTS];
+    int width;
+    int height;
+    render_pass_setup_t setup;
+    const void* user;
+    int output;
+};
+
+// texture exchanged between passes, imported or written by a pass into a pooled target
+struct render_resource_s
+{
+    GLuint texture;
+    int producer;               // pass writing it, -1 when imported
+    int last_reader;            // its target returns to the pool after this pass
+    int target;
+};
+
+// Passes are declared every frame then only those the requested output depends on run.
+// Their targets come from a pool allocated once per resolution, a chain of passes
+// ping-pongs between two of them.
+struct render_graph_s
+{
+    render_pass_t passes[RENDER_GRAPH_MAX_PASSES];
+    int pass_count;
+    render_resource_t resources[RENDER_GRAPH_MAX_RESOURCES];
+    int resource_count;
+    render_target_t pool[RENDER_GRAPH_POOL_SIZE];
+    int pool_busy[RENDER_GRAPH_POOL_SIZE];
+};
+
+// Per pixel color transform baked over a grid, sampled with a single fetch
+struct color_lut_s
+{
+    GLuint program;             // bakes one slice of the grid per draw
+    GLuint texture;
+    GLuint fbo;
+    GLuint vao;                 // empty, the bake draws a full screen triangle from gl_VertexID
+    int max_size;
+    int size;                   // grid points per side, 0 when the quantization does not fit
+    int method;                 // parameters the texture was baked with, levels 0 until the first bake
+    int levels;
+};
+
+// Escape time gradients, one row of the texture each
+struct gradient_s
+{
+    const char* path;           // gradient library, GRADIENT_DEFAULT_PATH when not given
+    GLuint texture;
+    int count;
+    int current;                // row bound last, -1 before the first frame
+    char names[GRADIENT_MAX][GRADIENT_NAME_LENGTH];
+};
+
+// Sobel edge map, the dithering fades out across edges
+struct edge_detection_s
+{
+    GLuint program;             // fragment variant, reads its taps from the texture
+    GLuint compute_program;     // tiles the source in shared memory, 0 without OpenGL 4.3
+    GLuint vao;                 // empty, the fragment variant draws a full screen triangle
+    render_target_t target;     // GL_R8 edge strength
+};
+
+// dithering and quantization of fragment_postprocessing.frag
+struct postprocessing_s
+{
+    int dithering_pattern;
+    float dithering_strength;
+    int quantization_method;
+    int quantization_levels;
+    int diffusion_kernel;       // exports are diffused on the CPU instead, the GPU passes are skipped
+    int palette_colors;         // exports are indexed PNGs with that many colors at most, 0 for RGB
+    int palette_samples;        // pixels the palette is fitted on, every pixel when 0
+    GLuint program;             // render graph pass of the procedural generators
+    GLuint blue_noise;          // threshold texture of pattern 1, cached on disk
+    color_lut_t lut;            // quantization of every color
+    edge_detection_t edges;
+    int pixel_offset[2];        // position of the tile in the image, the patterns run across tiles
+};
+
+// images larger than a texture are post-processed offline, one strip of tiles at a time
+struct tiled_image_s
+{
+    int active;                 // the image is written tile by tile instead of displayed
+    int tile_size;              // forced with --tile-size, else TILED_IMAGE_TILE_SIZE
+    const char* output;
+    render_target_t tile;       // texels of the tile and of its overlap
+};
+
+// pan and zoom over images of any size, pages of a mip pyramid are streamed
+// from a page file into a cache texture of fixed size
+struct virtual_texture_s
+{
+    int enabled;                // --virtual
+    int width;                  // texels of the image
+    int height;
+    int levels;                 // the last level is a single page
+    int table_size;             // side of the first level of the page table, a power of two
+    int columns[VIRTUAL_TEXTURE_MAX_LEVELS];        // pages of every level
+    int rows[VIRTUAL_TEXTURE_MAX_LEVELS];
+    int first_page[VIRTUAL_TEXTURE_MAX_LEVELS];     // in the page file
+    int table_offset[VIRTUAL_TEXTURE_MAX_LEVELS];   // in table
+    int page_count;
+    int* page_slot;             // cache slot of every page, -1 when not resident
+    uint8_t* page_pending;      // handed to the loader
+    uint32_t* page_stamp;       // last frame the feedback asked for the page
+    int* slot_page;             // page of every cache slot, -1 when free
+    uint32_t* slot_used;        // last frame the page of the slot was asked for
+    int* wanted;                // pages asked for this frame and missing from the cache
+    uint8_t* table;             // copy of the page table, slot and level of the page or of its closest resident ancestor
+    int table_dirty;
+    uint32_t frame;
+    char path[VIRTUAL_TEXTURE_PATH_LENGTH];         // page file
+    GLuint cache;
+    GLuint table_texture;
+    GLuint program;
+    GLuint feedback_program;
+    GLuint vao;
+    GLuint pbo[2];              // feedback of the two last frames, read back without waiting
+    int pbo_width[2];
+    int pbo_height[2];
+    int pbo_index;
+    render_target_t target;
+    render_target_t feedback;   // GL_RG32I, page and level asked for by every pixel
+    page_loader_t* loader;
+};
+
 struct state_s 
 {
     int width;
@@ -57,9 +481,21 @@ struct state_s
     double last_x;
     double last_y;
     int is_dragging;
+    double last_interaction;
 
     // UI state
     int show_glow;
+    int dynamic_resolution;
+    int checkerboard;
+    int symmetry;
+    int compute_backend;
+    int canopy_raster;
+    int canopy_animate;
+    int distance_effect;
+    int postprocess;
+    int gradient;
+    int gradient_count;
+    canopy_params_t canopy;
 };
 
 struct data_s
@@ -73,6 +509,24 @@ struct data_s
     GLuint texture;
     GLFWwindow* window;
     state_t state;
+    dynres_t dynres;
+    checkerboard_t checkerboard;
+    iteration_budget_t budget;
+    mirror_band_t mirror;
+    mandelbrot_compute_t compute;
+    canopy_t canopy;
+    lsystem_t lsystem;
+    forest_t forest;
+    colonization_t colonization;
+    poisson_t poisson;
+    jump_flood_t jump_flood;
+    voronoi_t voronoi;
+    render_graph_t graph;
+    postprocessing_t postprocessing;
+    gradient_t gradient;
+    tiled_image_t tiled;
+    virtual_texture_t virtual_texture;
+    int benchmark;
 };
 
 #endif /* !STRUCTS_H_ */
\ No newline at end of file
@@ -0,0 +1,19 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef SYMMETRY_H_
+#define SYMMETRY_H_
+
+#include <stdio.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+int find_mirror_band(const state_t*, int, int, mirror_band_t*);
+void begin_mirror_band(const mirror_band_t*, int);
+void end_mirror_band(const mirror_band_t*, GLuint, int);
+
+#endif /* !SYMMETRY_H_ */
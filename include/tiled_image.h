@@ -0,0 +1,30 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef TILED_IMAGE_H_
+#define TILED_IMAGE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+#include <png.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#define TILED_IMAGE_TILE_SIZE 2048
+#define TILED_IMAGE_OVERLAP 1       // radius of the Sobel and error diffusion taps, the widest filters of the chain
+#define TILED_IMAGE_OUTPUT "export/tiled.png"
+
+int open_row_reader(const char*, row_reader_t**, int*, int*);
+int read_rows(row_reader_t*, uint8_t*, int, size_t);
+void close_row_reader(row_reader_t*);
+int init_tiled_image(tiled_image_t*, int, int);
+int process_tiled_image(tiled_image_t*, postprocessing_t*, render_graph_t*, GLuint, const char*);
+void free_tiled_image(tiled_image_t*);
+
+#endif /* !TILED_IMAGE_H_ */
@@ -0,0 +1,39 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef VIRTUAL_TEXTURE_H_
+#define VIRTUAL_TEXTURE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#define VIRTUAL_TEXTURE_PAGE_SIZE 128       // texels of a page, its border excluded
+#define VIRTUAL_TEXTURE_BORDER 1            // copied from the neighbor pages, bilinear filtering never crosses a slot
+#define VIRTUAL_TEXTURE_SLOT_SIZE (VIRTUAL_TEXTURE_PAGE_SIZE + 2 * VIRTUAL_TEXTURE_BORDER)
+#define VIRTUAL_TEXTURE_CACHE_COLUMNS 16    // the cache holds 16x16 pages, 17 MB whatever the image
+#define VIRTUAL_TEXTURE_FEEDBACK_SCALE 8    // the feedback is rendered at 1/8 of the window
+#define VIRTUAL_TEXTURE_UPLOADS 8           // pages uploaded per frame at most
+#define VIRTUAL_TEXTURE_JOBS 32             // pages handed to the loader thread at once
+#define VIRTUAL_TEXTURE_CACHE_DIR "cache"
+#define VIRTUAL_TEXTURE_MAGIC 0x46505650u
+#define VIRTUAL_TEXTURE_VERSION 1
+
+int init_virtual_texture(virtual_texture_t*, const char*);
+int draw_virtual_texture(virtual_texture_t*, const state_t*, GLuint*);
+void free_virtual_texture(virtual_texture_t*);
+
+#endif /* !VIRTUAL_TEXTURE_H_ */
@@ -0,0 +1,28 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#ifndef VORONOI_H_
+#define VORONOI_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "structs.h"
+#include "error.h"
+#include "random.h"
+
+#define VORONOI_DEFAULT_SEEDS (1 << 20)
+#define VORONOI_DOMAIN 4.0f
+#define VORONOI_START_SPACING 24.0f
+#define VORONOI_GUARD 32
+#define VORONOI_SEED 0x2545f491u
+
+int init_voronoi(voronoi_t*, state_t*);
+int draw_voronoi(voronoi_t*, jump_flood_t*, GLuint, const state_t*, GLuint, int, int);
+void free_voronoi(voronoi_t*);
+
+#endif /* !VORONOI_H_ */
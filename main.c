@@ -17,12 +17,38 @@
 #include "include/save.h"
 #include "include/init.h"
 #include "include/error.h"
+#include "include/resolution.h"
+#include "include/checkerboard.h"
+#include "include/framebuffer.h"
+#include "include/iteration_budget.h"
+#include "include/symmetry.h"
+#include "include/mandelbrot_compute.h"
+#include "include/canopy.h"
+#include "include/lsystem.h"
+#include "include/forest.h"
+#include "include/colonization.h"
+#include "include/poisson.h"
+#include "include/jump_flood.h"
+#include "include/voronoi.h"
+#include "include/render_graph.h"
+#include "include/postprocessing.h"
+#include "include/error_diffusion.h"
+#include "include/palette.h"
+#include "include/gradient.h"
+#include "include/edge_detection.h"
+#include "include/tiled_image.h"
+#include "include/virtual_texture.h"
 
 #define WIDTH 800
 #define HEIGHT 600
 
+#define BENCH_WARMUP_FRAMES 16
+#define BENCH_FRAMES 64
+
 int parse_args(int, char**, data_t*);
-int display(GLFWwindow*, int, GLuint, GLuint, GLuint, state_t*);
+int parse_options(int, char**, int, data_t*);
+int display(data_t*);
+int benchmark(data_t*);
 
 int parse_args(int argc, char** argv, data_t* data)
 {
@@ -30,6 +56,7 @@ int parse_args(int argc, char** argv, data_t* data)
 
     if (argc > 1)
     {
+        int first_option = 2;
         if (!strcmp(argv[1], "mandelbrot"))
         {
             data->flag = PROCEDURAL | (MANDELBROT << 1);
@@ -38,10 +65,129 @@ int parse_args(int argc, char** argv, data_t* data)
         {
             data->flag = PROCEDURAL | (CANOPY << 1);
         }
+        else if (!strcmp(argv[1], "forest")) 
+        {
+            data->flag = PROCEDURAL | (FOREST << 1);
+        }
+        else if (!strcmp(argv[1], "colonization")) 
+        {
+            data->flag = PROCEDURAL | (COLONIZATION << 1);
+        }
+        else if (!strcmp(argv[1], "voronoi")) 
+        {
+            data->flag = PROCEDURAL | (VORONOI << 1);
+        }
+        else if (!strcmp(argv[1], "poisson")) 
+        {
+            data->flag = PROCEDURAL | (POISSON << 1);
+            if (argc > 2 && argv[2][0] != '-')
+            {
+                data->path = argv[2];
+                first_option = 3;
+            }
+        }
+        else if (!strcmp(argv[1], "lsystem") && argc > 2)
+        {
+            data->flag = PROCEDURAL | (LSYSTEM << 1);
+            data->path = argv[2];
+            first_option = 3;
+        }
         else if (!strcmp(argv[1], "file") && argc > 2)
         {
             data->flag = IMAGE;
             data->path = argv[2];
+            first_option = 3;
+        }
+        else return PG_INVALID_PARAMETER;
+
+        CHECK_CALL(parse_options, argc, argv, first_option, data);
+    }
+
+    return last_status;
+}
+
+int parse_options(int argc, char** argv, int first, data_t* data)
+{
+    int last_status = PG_SUCCESS;
+
+    for (int i = first; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--target-ms") && i + 1 < argc)
+        {
+            data->dynres.target_ms = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--min-scale") && i + 1 < argc)
+        {
+            data->dynres.min_scale = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--escape-fraction") && i + 1 < argc)
+        {
+            data->budget.fraction = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--bench"))
+        {
+            data->benchmark = 1;
+        }
+        else if (!strcmp(argv[i], "--tile-budget"))
+        {
+            data->budget.per_tile = 1;
+        }
+        else if (!strcmp(argv[i], "--radius") && i + 1 < argc)
+        {
+            data->poisson.radius = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--domain") && i + 1 < argc)
+        {
+            data->poisson.domain = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "--tiled"))
+        {
+            data->poisson.tiled = 1;
+        }
+        else if (!strcmp(argv[i], "--seeds") && i + 1 < argc)
+        {
+            data->voronoi.seed_count = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--gradients") && i + 1 < argc)
+        {
+            data->gradient.path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--dithering") && i + 1 < argc)
+        {
+            data->postprocessing.dithering_pattern = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--levels") && i + 1 < argc)
+        {
+            data->postprocessing.quantization_levels = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--diffusion") && i + 1 < argc)
+        {
+            CHECK_CALL(parse_diffusion_kernel, argv[++i], &data->postprocessing.diffusion_kernel);
+        }
+        else if (!strcmp(argv[i], "--palette") && i + 1 < argc)
+        {
+            data->postprocessing.palette_colors = atoi(argv[++i]);
+            if (data->postprocessing.palette_colors < 2 || data->postprocessing.palette_colors > PALETTE_MAX_COLORS)
+            {
+                return PG_INVALID_PARAMETER;
+            }
+        }
+        else if (!strcmp(argv[i], "--palette-samples") && i + 1 < argc)
+        {
+            data->postprocessing.palette_samples = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--tile-size") && i + 1 < argc)
+        {
+            data->tiled.tile_size = atoi(argv[++i]);
+            if (data->tiled.tile_size < 1) return PG_INVALID_PARAMETER;
+        }
+        else if (!strcmp(argv[i], "--tile-output") && i + 1 < argc)
+        {
+            data->tiled.output = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--virtual"))
+        {
+            data->virtual_texture.enabled = 1;
         }
         else return PG_INVALID_PARAMETER;
     }
@@ -49,9 +195,23 @@ int parse_args(int argc, char** argv, data_t* data)
     return last_status;
 }
 
-int display(GLFWwindow* window, int type, GLuint shader_program, GLuint VAO, GLuint texture, state_t* state)
+int display(data_t* data)
 {
     int last_status = PG_SUCCESS;
+    int type = data->flag & 1;
+    GLuint shader_program = data->shader_program;
+    state_t* state = &data->state;
+    int render_width = state->width;
+    int render_height = state->height;
+    int checkerboard = 0;
+    int symmetric = 0;
+    int compute = 0;
+    int raster = 0;
+    float offset_y = state->offset[1];
+    GLuint output_texture = 0;
+    GLuint output_fbo = 0;
+    GLuint edge_texture = 0;
+
     // Clear screen
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -70,34 +230,178 @@ int display(GLFWwindow* window, int type, GLuint shader_program, GLuint VAO, GLu
     {
         case PROCEDURAL:
 
-            glUniform1f(glGetUniformLocation(shader_program, "thickness"), 0.005);
-            glUniform1f(glGetUniformLocation(shader_program, "branch_angle"), M_PI/6);
-            glUniform1f(glGetUniformLocation(shader_program, "branch_length"), 0.5);
-            glUniform1f(glGetUniformLocation(shader_program, "decay"), 0.5);
-            glUniform3f(glGetUniformLocation(shader_program, "color1"), 0.0, 0.0, 0.0);
-            glUniform3f(glGetUniformLocation(shader_program, "color2"), 0.5, 1.0, 0.7);
-            
-            glUniform2f(resolution_loc, (float)state->width, (float)state->height);
-            glUniform1f(time_loc, glfwGetTime());
-            glUniform1f(zoom_loc, state->zoom);
-            glUniform2f(offset_loc, state->offset[0], state->offset[1]);
-            glUniform1f(glow_loc, state->show_glow);
-
-            glBindVertexArray(VAO);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            // iteration budget from the escape counts of a sparse probe
+            if ((data->flag >> 1) == MANDELBROT)
+            {
+                CHECK_CALL(update_iteration_budget, &data->budget, state, shader_program, data->vao);
+                bind_gradient(&data->gradient, state->gradient, shader_program);
+            }
+
+            // canopy branches are regenerated on the CPU when a parameter changes
+            if ((data->flag >> 1) == CANOPY)
+            {
+                CHECK_CALL(update_canopy, &data->canopy, &state->canopy);
+            }
+
+            // generators may draw offscreen at a reduced resolution while the view moves
+            CHECK_CALL(begin_dynamic_resolution, &data->dynres, state, &render_width, &render_height);
+
+            // shade only one side of the real axis, the other is a mirrored copy
+            if ((data->flag >> 1) == MANDELBROT && state->symmetry)
+            {
+                symmetric = find_mirror_band(state, render_width, render_height, &data->mirror);
+                if (symmetric) offset_y = data->mirror.offset_y;
+            }
+
+            // persistent threads compute backend, shades into its own image
+            compute = (data->flag >> 1) == MANDELBROT && state->compute_backend && data->compute.available;
+            if (compute)
+            {
+                bind_gradient(&data->gradient, state->gradient, data->compute.program);
+                CHECK_CALL(dispatch_mandelbrot_compute, &data->compute, state, &data->budget, 
+                    render_width, render_height, offset_y, symmetric ? &data->mirror : NULL);
+                output_texture = data->compute.target.texture;
+                output_fbo = data->compute.target.fbo;
+                reset_checkerboard(&data->checkerboard);
+            }
+            else
+            {
+                // rasterized canopy only shades covered pixels, there is nothing to reconstruct
+                raster = ((data->flag >> 1) == CANOPY && (state->canopy_raster || state->canopy_animate)) || 
+                    (data->flag >> 1) == LSYSTEM || (data->flag >> 1) == FOREST || (data->flag >> 1) == COLONIZATION || 
+                    (data->flag >> 1) == POISSON || (data->flag >> 1) == VORONOI;
+
+                // and shade only half of the pixels, the others are reconstructed
+                checkerboard = state->checkerboard && is_interacting(state) && !raster;
+                if (checkerboard)
+                {
+                    CHECK_CALL(begin_checkerboard, &data->checkerboard, render_width, render_height);
+                }
+                else if (render_width != state->width || render_height != state->height || symmetric || 
+                    state->distance_effect || state->postprocess)
+                {
+                    // the window framebuffer is multisampled and cannot be blitted onto itself,
+                    // nor sampled by the distance effects and the post-processing
+                    CHECK_CALL(resize_render_target, &data->dynres.target, render_width, render_height, GL_RGBA8);
+                    bind_render_target(&data->dynres.target);
+                    output_texture = data->dynres.target.texture;
+                    output_fbo = data->dynres.target.fbo;
+                }
+
+                if (symmetric)
+                {
+                    begin_mirror_band(&data->mirror, render_width);
+                }
+
+                if ((data->flag >> 1) == LSYSTEM)
+                {
+                    draw_lsystem(&data->lsystem, shader_program, render_width, render_height);
+                }
+                else if ((data->flag >> 1) == FOREST)
+                {
+                    draw_forest(&data->forest, shader_program, state, render_width, render_height);
+                }
+                else if ((data->flag >> 1) == COLONIZATION)
+                {
+                    draw_colonization(&data->colonization, shader_program, render_width, render_height);
+                }
+                else if ((data->flag >> 1) == POISSON)
+                {
+                    draw_poisson(&data->poisson, shader_program, state, render_width, render_height);
+                }
+                else if ((data->flag >> 1) == VORONOI)
+                {
+                    CHECK_CALL(draw_voronoi, &data->voronoi, &data->jump_flood, shader_program, state, 
+                        data->vao, render_width, render_height);
+                }
+                else if (raster && state->canopy_animate)
+                {
+                    CHECK_CALL(draw_animated_canopy, &data->canopy, &state->canopy, (float)glfwGetTime(), render_width, render_height);
+                }
+                else if (raster)
+                {
+                    draw_canopy_segments(&data->canopy, &state->canopy, render_width, render_height);
+                }
+                else
+                {
+                    glUseProgram(shader_program);
+                    if ((data->flag >> 1) == CANOPY)
+                    {
+                        set_canopy_uniforms(&data->canopy, &state->canopy, shader_program);
+                    }
+                    
+                    glUniform2f(resolution_loc, (float)render_width, (float)render_height);
+                    glUniform1f(time_loc, glfwGetTime());
+                    glUniform1f(zoom_loc, state->zoom);
+                    glUniform2f(offset_loc, state->offset[0], offset_y);
+                    glUniform1f(glow_loc, state->show_glow);
+                    glUniform1i(glGetUniformLocation(shader_program, "checkerboard_parity"), checkerboard ? data->checkerboard.parity : -1);
+
+                    glBindVertexArray(data->vao);
+                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                }
+
+                if (checkerboard)
+                {
+                    if (symmetric) glDisable(GL_SCISSOR_TEST);
+                    CHECK_CALL(resolve_checkerboard, &data->checkerboard, state, render_width, render_height, 
+                        data->vao, (data->flag >> 1) == MANDELBROT, &output_texture);
+                    output_fbo = data->checkerboard.history[data->checkerboard.current].fbo;
+                }
+                else
+                {
+                    reset_checkerboard(&data->checkerboard);
+                }
+            }
+
+            if (symmetric)
+            {
+                end_mirror_band(&data->mirror, output_fbo, render_width);
+            }
+
+            // outlines, glow and thick strokes from the distance to the drawn shapes,
+            // the width follows the render scale to look the same once upscaled
+            if (state->distance_effect)
+            {
+                float effect_width = JUMP_FLOOD_EFFECT_WIDTH * (float)render_height / (float)state->height;
+                CHECK_CALL(apply_distance_effect, &data->jump_flood, state->distance_effect, effect_width, 
+                    output_texture, render_width, render_height, data->vao, &output_texture);
+            }
+
+            // dithering and quantization chain, fed by the offscreen output without readback
+            if (output_texture)
+            {
+                CHECK_CALL(run_postprocessing, &data->postprocessing, &data->graph, &data->dynres, state, 
+                    render_width, render_height, data->vao, &output_texture);
+            }
+
+            CHECK_CALL(end_dynamic_resolution, &data->dynres, state, data->vao, output_texture);
             break;
 
         case IMAGE:
             
+            CHECK_CALL(prepare_postprocessing, &data->postprocessing);
+            output_texture = data->texture;
+            edge_texture = data->postprocessing.edges.target.texture;
+
+            // the visible pages of the image, at the window size, then their edges
+            if (data->virtual_texture.enabled)
+            {
+                CHECK_CALL(draw_virtual_texture, &data->virtual_texture, state, &output_texture);
+                CHECK_CALL(detect_edges, &data->postprocessing.edges, output_texture, state->width, state->height, &edge_texture);
+                unbind_render_target(state->width, state->height);
+                glUseProgram(shader_program);
+            }
+
             glUniform1i(glGetUniformLocation(shader_program, "source_texture"), 0);
-            glUniform1i(glGetUniformLocation(shader_program, "dithering_pattern"), 0);
-            glUniform1f(glGetUniformLocation(shader_program, "dithering_strength"), 0.2);
-            glUniform1i(glGetUniformLocation(shader_program, "quantization_method"), 2);
-            glUniform1i(glGetUniformLocation(shader_program, "quantization_levels"), 8);
+            set_postprocessing_uniforms(shader_program, &data->postprocessing);
+            glUniform1i(glGetUniformLocation(shader_program, "edge_texture"), 1);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, edge_texture);
 
             glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glBindVertexArray(VAO);
+            glBindTexture(GL_TEXTURE_2D, output_texture);
+            glBindVertexArray(data->vao);
             glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
             break;
 
@@ -106,12 +410,66 @@ int display(GLFWwindow* window, int type, GLuint shader_program, GLuint VAO, GLu
     }
 
     // Swap buffers and poll events
-    glfwSwapBuffers(window);
+    glfwSwapBuffers(data->window);
     glfwPollEvents();
 
     return last_status;
 }
 
+// Render the same view with both Mandelbrot backends and compare GPU frame times
+int benchmark(data_t* data)
+{
+    int last_status = PG_SUCCESS;
+    const char* backends[2] = { "fragment", "compute" };
+    GLuint queries[2];
+    double ms[2] = { 0.0, 0.0 };
+
+    if ((data->flag >> 1) != MANDELBROT || !data->compute.available)
+    {
+        fprintf(stderr, "Benchmark needs the Mandelbrot generator and OpenGL 4.3\n");
+        return PG_INVALID_PARAMETER;
+    }
+
+    // native resolution and every pixel shaded for both backends
+    glfwSwapInterval(0);
+    data->state.dynamic_resolution = 0;
+    data->state.checkerboard = 0;
+    glGenQueries(2, queries);
+
+    for (int backend = 0; backend < 2; backend++)
+    {
+        data->state.compute_backend = backend;
+
+        // warm up, lets the iteration budget settle too
+        for (int frame = 0; frame < BENCH_WARMUP_FRAMES; frame++)
+        {
+            CHECK_CALL(display, data);
+        }
+        glFinish();
+
+        for (int frame = 0; frame < BENCH_FRAMES; frame++)
+        {
+            GLuint64 start = 0;
+            GLuint64 end = 0;
+            glQueryCounter(queries[0], GL_TIMESTAMP);
+            CHECK_CALL(display, data);
+            glQueryCounter(queries[1], GL_TIMESTAMP);
+            glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+            ms[backend] += (double)(end - start) * 1e-6;
+        }
+        ms[backend] /= BENCH_FRAMES;
+
+        printf("[>] Benchmark %s backend: %.3f ms per frame at %dx%d\n", 
+            backends[backend], ms[backend], data->state.width, data->state.height);
+    }
+
+    printf("[>] Compute backend speedup: %.2fx\n", ms[0] / ms[1]);
+    glDeleteQueries(2, queries);
+
+    return last_status;
+}
+
 int main(int argc, char** argv) 
 {
     int last_status = PG_SUCCESS;
@@ -127,16 +485,23 @@ int main(int argc, char** argv)
     CHECK_CALL_GOTO_ERROR(create_shader_program, cleanup, &data)
 
     printf("[>] Initialization done.\n");
+
+    if (data.benchmark)
+    {
+        CHECK_CALL_GOTO_ERROR(benchmark, cleanup, &data);
+        goto cleanup;
+    }
+
+    if (data.tiled.active)
+    {
+        CHECK_CALL_GOTO_ERROR(process_tiled_image, cleanup, &data.tiled, &data.postprocessing, &data.graph, data.vao, data.path);
+        goto cleanup;
+    }
+
     // main
     while (!glfwWindowShouldClose(data.window)) 
     {
-        CHECK_CALL_GOTO_ERROR(display, cleanup, 
-            data.window, 
-            data.flag & 1, 
-            data.shader_program, 
-            data.vao, 
-            data.texture,
-            &data.state);
+        CHECK_CALL_GOTO_ERROR(display, cleanup, &data);
     }
 
     // export
@@ -148,6 +513,22 @@ int main(int argc, char** argv)
     glDeleteBuffers(1, &data.vbo);
     glDeleteBuffers(1, &data.ebo);
     glDeleteProgram(data.shader_program);
+    free_dynamic_resolution(&data.dynres);
+    free_checkerboard(&data.checkerboard);
+    free_iteration_budget(&data.budget);
+    free_mandelbrot_compute(&data.compute);
+    free_gradient(&data.gradient);
+    free_canopy(&data.canopy);
+    free_lsystem(&data.lsystem);
+    free_forest(&data.forest);
+    free_colonization(&data.colonization);
+    free_poisson(&data.poisson);
+    free_jump_flood(&data.jump_flood);
+    free_voronoi(&data.voronoi);
+    free_render_graph(&data.graph);
+    free_tiled_image(&data.tiled);
+    free_virtual_texture(&data.virtual_texture);
+    free_postprocessing(&data.postprocessing);
     
     glfwTerminate();
     return last_status;
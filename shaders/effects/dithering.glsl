@@ -22,7 +22,7 @@ const float bayer_matrix[64] = float[64](
     42.0/64.0, 26.0/64.0, 38.0/64.0, 22.0/64.0, 41.0/64.0, 25.0/64.0, 37.0/64.0, 21.0/64.0
 );
 
-// Blue noise texture (you would need to provide this as a uniform)
+// Blue noise threshold texture, generated once by void-and-cluster then read from the cache
 uniform sampler2D blue_noise_texture;
 
 // Hash function for random dithering
@@ -45,7 +45,8 @@ float error_diffusion(vec2 pos)
     return error;
 }
 
-vec3 apply_dithering(vec2 frag_coord, vec3 color, vec3 neighbor_color, int dithering_pattern, float strength) 
+// edge is the Sobel magnitude of the source around the pixel, from edge_detection.glsl
+vec3 apply_dithering(vec2 frag_coord, vec3 color, float edge, int dithering_pattern, float strength) 
 {
     float dither = 0.0;
     float luma = get_luminance(color);
@@ -77,15 +78,13 @@ vec3 apply_dithering(vec2 frag_coord, vec3 color, vec3 neighbor_color, int dithe
     }
     else if (dithering_pattern == 4)
     {
-        // Simplified error diffusion using neighboring pixels
+        // Simplified error diffusion using neighboring pixels,
+        // the error cannot propagate here, exports get the real one with --diffusion
         dither = error_diffusion(frag_coord);
     }
     
-    vec3 color_diff = abs(color - neighbor_color);
-    vec3 edge_intensity = 1.0 - smoothstep(0.0, 0.1, color_diff);
-    
     // Reduce dithering near edges
-    local_dither_strength *= min(edge_intensity.r, min(edge_intensity.g, edge_intensity.b));
+    local_dither_strength *= 1.0 - smoothstep(0.0, 0.1, edge);
 
     // Apply dithering
     return color + (dither - 0.5) * local_dither_strength * (1.0 - abs(color - 0.5));
@@ -0,0 +1,51 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D half_texture;     // pixels shaded this frame, packed two per column
+uniform sampler2D history_texture;  // previous resolved frame
+uniform vec2 resolution;
+uniform int parity;
+uniform bool history_valid;
+uniform vec2 reproject_scale;       // maps current uv to previous frame uv
+uniform vec2 reproject_offset;
+
+vec3 fetch_shaded(ivec2 p)
+{
+    p = clamp(p, ivec2(0), ivec2(resolution) - 1);
+    return texelFetch(half_texture, ivec2(p.x / 2, p.y), 0).rgb;
+}
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    if (((p.x + p.y) & 1) == parity)
+    {
+        FragColor = vec4(fetch_shaded(p), 1.0);
+        return;
+    }
+
+    // the four direct neighbours were shaded this frame
+    vec3 left = fetch_shaded(p + ivec2(-1, 0));
+    vec3 right = fetch_shaded(p + ivec2(1, 0));
+    vec3 down = fetch_shaded(p + ivec2(0, -1));
+    vec3 up = fetch_shaded(p + ivec2(0, 1));
+    vec3 spatial = (left + right + down + up) * 0.25;
+
+    vec2 prev_uv = (gl_FragCoord.xy / resolution) * reproject_scale + reproject_offset;
+    if (!history_valid || any(lessThan(prev_uv, vec2(0.0))) || any(greaterThan(prev_uv, vec2(1.0))))
+    {
+        FragColor = vec4(spatial, 1.0);
+        return;
+    }
+
+    // clamp the reprojected colour to the neighbourhood to limit ghosting
+    vec3 history = texture(history_texture, prev_uv).rgb;
+    vec3 lo = min(min(left, right), min(down, up));
+    vec3 hi = max(max(left, right), max(down, up));
+
+    FragColor = vec4(clamp(history, lo, hi), 1.0);
+}
@@ -0,0 +1,21 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform int slice;
+uniform int lut_size;
+uniform int quantization_method;    // negative for none, the chain is then the identity
+uniform int quantization_levels;
+
+#include "quantization.glsl"
+
+void main()
+{
+    // grid points span [0, 1] ends included
+    vec3 color = vec3(floor(gl_FragCoord.xy), float(slice)) / float(lut_size - 1);
+
+    FragColor = vec4(apply_quantization(color, quantization_method, quantization_levels), 1.0);
+}
@@ -0,0 +1,16 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D source_texture;
+uniform vec2 texel_size;            // 1 / size of the source, which is also the size of the target
+
+#include "edge_detection.glsl"
+
+void main()
+{
+    FragColor = vec4(edge_intensity(source_texture, gl_FragCoord.xy * texel_size, texel_size));
+}
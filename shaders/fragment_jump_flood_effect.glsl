@@ -0,0 +1,54 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D source_texture;
+uniform sampler2D field_texture;
+uniform int effect;
+uniform float width;
+
+#define EFFECT_OUTLINE 1
+#define EFFECT_GLOW 2
+#define EFFECT_STROKE 3
+
+const vec3 outline_color = vec3(1.0, 0.95, 0.8);
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 color = texelFetch(source_texture, pixel, 0);
+    vec2 seed = texelFetch(field_texture, pixel, 0).xy;
+
+    // out of the flooded reach
+    if (seed.x < 0.0)
+    {
+        FragColor = color;
+        return;
+    }
+
+    float d = distance(seed, vec2(pixel));
+    vec3 seed_color = texelFetch(source_texture, ivec2(seed), 0).rgb;
+
+    // pixel centers are whole pixels apart, the half pixel smooths the edge
+    float band = clamp(width + 0.5 - d, 0.0, 1.0);
+    vec3 result = color.rgb;
+
+    if (effect == EFFECT_OUTLINE)
+    {
+        result = d > 0.0 ? mix(color.rgb, outline_color, band) : color.rgb;
+    }
+    else if (effect == EFFECT_GLOW)
+    {
+        result = d > 0.0 ? color.rgb + seed_color * exp(-d / width) : color.rgb;
+    }
+    else if (effect == EFFECT_STROKE)
+    {
+        // shapes grown by width in the color of their nearest pixel
+        result = mix(color.rgb, seed_color, band);
+    }
+
+    FragColor = vec4(result, color.a);
+}
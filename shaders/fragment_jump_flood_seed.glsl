@@ -0,0 +1,19 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D source_texture;
+uniform float threshold;
+
+void main()
+{
+    // bright pixels are their own nearest seed, the others have none yet
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec3 color = texelFetch(source_texture, pixel, 0).rgb;
+    float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+
+    FragColor = luminance > threshold ? vec4(vec2(pixel), 0.0, 1.0) : vec4(-1.0);
+}
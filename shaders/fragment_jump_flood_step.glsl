@@ -0,0 +1,40 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D field_texture;
+uniform int jump;
+
+void main()
+{
+    // keep the nearest of the seeds known by the 3x3 pixels one step apart
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 size = textureSize(field_texture, 0);
+    vec2 nearest = vec2(-1.0);
+    float nearest_distance = 1e30;
+
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 neighbor = pixel + ivec2(x, y) * jump;
+            if (any(lessThan(neighbor, ivec2(0))) || any(greaterThanEqual(neighbor, size))) continue;
+
+            vec2 seed = texelFetch(field_texture, neighbor, 0).xy;
+            if (seed.x < 0.0) continue;
+
+            vec2 delta = seed - vec2(pixel);
+            float squared = dot(delta, delta);
+            if (squared < nearest_distance)
+            {
+                nearest_distance = squared;
+                nearest = seed;
+            }
+        }
+    }
+
+    FragColor = vec4(nearest, 0.0, 1.0);
+}
@@ -0,0 +1,26 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out ivec2 feedback;
+
+uniform float feedback_scale;       // window pixels per feedback pixel
+
+#include "virtual_texture.glsl"
+
+// Page and level seen by the pixel, column and row of the page packed in 16 bits each
+void main()
+{
+    vec2 position = image_position(gl_FragCoord.xy * feedback_scale);
+    int level = image_level(position, -log2(feedback_scale));
+
+    if (!inside_image(position))
+    {
+        feedback = ivec2(-1);
+        return;
+    }
+
+    ivec2 page = image_page(position, level);
+    feedback = ivec2(page.x | (page.y << 16), level);
+}
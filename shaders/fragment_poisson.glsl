@@ -0,0 +1,20 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+in vec2 local;
+flat in float dot_radius;
+
+uniform vec3 color2;
+
+void main()
+{
+    // disc with a one pixel wide edge
+    float d = length(local);
+    float coverage = clamp((dot_radius - d) / max(fwidth(d), 1e-6) + 0.5, 0.0, 1.0);
+
+    FragColor = vec4(color2, coverage);
+}
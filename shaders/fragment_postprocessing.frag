@@ -9,8 +9,12 @@ out vec4 FragColor;
 uniform sampler2D source_texture;
 uniform int dithering_pattern;
 uniform float dithering_strength;
+uniform sampler3D color_lut;        // quantization, baked by fragment_color_lut.glsl
+uniform float lut_size;             // 0 when the levels do not fit in the LUT
 uniform int quantization_method;
 uniform int quantization_levels;
+uniform sampler2D edge_texture;     // Sobel magnitude of the source, by detect_edges or its CPU twin
+uniform vec2 pixel_offset;          // position of the tile in the image, 0 outside of tiled images
 
 // Include other shader files
 #include "dithering.glsl"
@@ -23,13 +27,20 @@ void main()
     
     // Apply effects in sequence
     vec3 result = color.rgb;
-    vec3 neighbor_color = textureOffset(source_texture, TexCoord, ivec2(1, 1)).rgb;
+    float edge = texture(edge_texture, TexCoord).r;
     
-    // quantize
-    result = apply_quantization(result, quantization_method, quantization_levels);
+    // quantize, the texel centers of the LUT sit on its grid points
+    if (lut_size > 0.0)
+    {
+        result = texture(color_lut, (result * (lut_size - 1.0) + 0.5) / lut_size).rgb;
+    }
+    else
+    {
+        result = apply_quantization(result, quantization_method, quantization_levels);
+    }
 
     // dithering
-    result = apply_dithering(gl_FragCoord.xy, result, neighbor_color, dithering_pattern, dithering_strength);
+    result = apply_dithering(gl_FragCoord.xy + pixel_offset, result, edge, dithering_pattern, dithering_strength);
     
     FragColor = vec4(result, color.a);
 }
@@ -0,0 +1,25 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+in vec2 local;
+flat in float branch_length;
+
+uniform float thickness;
+uniform vec3 color2;
+
+void main()
+{
+    // distance to the branch, measured in its own frame
+    float along = max(max(-local.x, local.x - branch_length), 0.0);
+    float lines = abs(length(vec2(along, local.y)) - thickness);
+
+    // never narrower than a pixel so thin branches do not alias
+    float edge = max(thickness, fwidth(lines));
+    float coverage = 1.0 - smoothstep(0.0, edge, lines);
+
+    FragColor = vec4(color2, coverage);
+}
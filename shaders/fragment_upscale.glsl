@@ -0,0 +1,15 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D source_texture;
+uniform vec2 resolution;
+
+void main()
+{
+    // bilinear upscale of the offscreen render to the window
+    FragColor = texture(source_texture, gl_FragCoord.xy / resolution);
+}
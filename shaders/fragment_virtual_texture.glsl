@@ -0,0 +1,17 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+#include "virtual_texture.glsl"
+
+void main()
+{
+    vec2 position = image_position(gl_FragCoord.xy);
+    int level = image_level(position, 0.0);
+
+    // same background as the window
+    FragColor = inside_image(position) ? vec4(sample_virtual(position, level).rgb, 1.0) : vec4(0.2, 0.3, 0.3, 1.0);
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out vec4 FragColor;
+
+uniform isampler2D field_texture;
+uniform samplerBuffer seed_texture;
+uniform vec2 offset;
+uniform float pixel_scale;
+uniform vec2 center;
+uniform int guard;
+uniform float spacing;
+
+vec2 seed_pixel(int id)
+{
+    return (texelFetch(seed_texture, id).xy - offset) * pixel_scale + center;
+}
+
+// integer hash, every cell keeps its color while the view moves
+float cell_hash(int id)
+{
+    uint h = uint(id) * 0x9e3779b1u;
+    h ^= h >> 15;
+    h *= 0x85ebca77u;
+    h ^= h >> 13;
+    return float(h & 0xffffu) / 65535.0;
+}
+
+void main()
+{
+    vec2 pixel = gl_FragCoord.xy + vec2(guard);
+    ivec2 nearest = texelFetch(field_texture, ivec2(pixel), 0).xy;
+    if (nearest.x < 0)
+    {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // Worley F1, darker away from the seed
+    vec2 first = seed_pixel(nearest.x);
+    float f1 = distance(first, pixel);
+    vec3 cell = 0.5 + 0.5 * cos(6.28318 * (cell_hash(nearest.x) + vec3(0.0, 0.33, 0.67)));
+    vec3 color = cell * (1.0 - 0.6 * clamp(f1 / spacing, 0.0, 1.0));
+
+    // F2 gives the distance to the bisector of the two nearest seeds, a one pixel border
+    // fading out once cells are only a few pixels wide
+    if (nearest.y >= 0)
+    {
+        vec2 second = seed_pixel(nearest.y);
+        float f2 = distance(second, pixel);
+        float edge = (f2 * f2 - f1 * f1) / (2.0 * max(distance(first, second), 1e-6));
+        float border = (1.0 - clamp(edge, 0.0, 1.0)) * clamp(spacing / 8.0 - 0.5, 0.0, 1.0);
+        color *= 1.0 - border;
+    }
+
+    FragColor = vec4(color, 1.0);
+}
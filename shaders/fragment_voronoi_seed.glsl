@@ -0,0 +1,14 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out ivec2 FragColor;
+
+flat in int seed_id;
+
+void main()
+{
+    // nearest seed, no second one yet
+    FragColor = ivec2(seed_id, -1);
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+out ivec2 FragColor;
+
+uniform isampler2D field_texture;
+uniform samplerBuffer seed_texture;
+uniform int jump;
+uniform vec2 offset;
+uniform float pixel_scale;
+uniform vec2 center;
+
+vec2 seed_pixel(int id)
+{
+    return (texelFetch(seed_texture, id).xy - offset) * pixel_scale + center;
+}
+
+void main()
+{
+    // keep the two nearest distinct seeds known by the 3x3 pixels one step apart,
+    // distances are to the exact seed positions, not to the pixels they were splat in
+    vec2 pixel = gl_FragCoord.xy;
+    ivec2 size = textureSize(field_texture, 0);
+    ivec2 nearest = ivec2(-1);
+    vec2 nearest_distance = vec2(1e30);
+
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 neighbor = ivec2(pixel) + ivec2(x, y) * jump;
+            if (any(lessThan(neighbor, ivec2(0))) || any(greaterThanEqual(neighbor, size))) continue;
+
+            ivec2 ids = texelFetch(field_texture, neighbor, 0).xy;
+            for (int k = 0; k < 2; k++)
+            {
+                int id = ids[k];
+                if (id < 0 || id == nearest.x || id == nearest.y) continue;
+
+                vec2 delta = seed_pixel(id) - pixel;
+                float squared = dot(delta, delta);
+                if (squared < nearest_distance.x)
+                {
+                    nearest = ivec2(id, nearest.x);
+                    nearest_distance = vec2(squared, nearest_distance.x);
+                }
+                else if (squared < nearest_distance.y)
+                {
+                    nearest.y = id;
+                    nearest_distance.y = squared;
+                }
+            }
+        }
+    }
+
+    FragColor = nearest;
+}
@@ -0,0 +1,19 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+// no version indication here it will be included and not used as its own
+
+// Checkerboard rendering packs the pixels of one parity two per column,
+// the target is half as wide and every invocation does useful work.
+// A negative parity shades every pixel.
+uniform int checkerboard_parity;
+
+vec2 get_frag_coord()
+{
+    if (checkerboard_parity < 0) return gl_FragCoord.xy;
+
+    float row = floor(gl_FragCoord.y);
+    float shift = mod(row + float(checkerboard_parity), 2.0);
+    return vec2(floor(gl_FragCoord.x) * 2.0 + shift + 0.5, gl_FragCoord.y);
+}
@@ -4,23 +4,30 @@
 
 // no version indication here it will be included and not used as its own
 
-float getEdgeIntensity(vec2 uv) {
-    vec3 center = texture(sourceTexture, uv).rgb;
-    
-    // Sobel operators
-    vec3 dx = -texture(sourceTexture, uv + vec2(-1, -1) / textureSize(sourceTexture, 0)).rgb
-              -2.0 * texture(sourceTexture, uv + vec2(-1, 0) / textureSize(sourceTexture, 0)).rgb
-              -texture(sourceTexture, uv + vec2(-1, 1) / textureSize(sourceTexture, 0)).rgb
-              +texture(sourceTexture, uv + vec2(1, -1) / textureSize(sourceTexture, 0)).rgb
-              +2.0 * texture(sourceTexture, uv + vec2(1, 0) / textureSize(sourceTexture, 0)).rgb
-              +texture(sourceTexture, uv + vec2(1, 1) / textureSize(sourceTexture, 0)).rgb;
-              
-    vec3 dy = -texture(sourceTexture, uv + vec2(-1, -1) / textureSize(sourceTexture, 0)).rgb
-              -2.0 * texture(sourceTexture, uv + vec2(0, -1) / textureSize(sourceTexture, 0)).rgb
-              -texture(sourceTexture, uv + vec2(1, -1) / textureSize(sourceTexture, 0)).rgb
-              +texture(sourceTexture, uv + vec2(-1, 1) / textureSize(sourceTexture, 0)).rgb
-              +2.0 * texture(sourceTexture, uv + vec2(0, 1) / textureSize(sourceTexture, 0)).rgb
-              +texture(sourceTexture, uv + vec2(1, 1) / textureSize(sourceTexture, 0)).rgb;
-              
-    return length(dx) + length(dy);
-}
\ No newline at end of file
+// same scale as EDGE_SCALE of edge_detection.h, a full black to white step gives 1
+#define EDGE_SCALE 0.25
+
+// Sobel magnitude from the 8 neighbors, shared by the fragment and compute variants
+// and mirrored by detect_edges_cpu
+float sobel(vec3 top_left, vec3 top, vec3 top_right, vec3 left, vec3 right, 
+    vec3 bottom_left, vec3 bottom, vec3 bottom_right)
+{
+    vec3 dx = (top_right + 2.0 * right + bottom_right) - (top_left + 2.0 * left + bottom_left);
+    vec3 dy = (bottom_left + 2.0 * bottom + bottom_right) - (top_left + 2.0 * top + top_right);
+
+    return clamp((length(dx) + length(dy)) * EDGE_SCALE, 0.0, 1.0);
+}
+
+// texel is 1 / size of the source, given by the caller instead of a textureSize per tap
+float edge_intensity(sampler2D source, vec2 uv, vec2 texel)
+{
+    return sobel(
+        texture(source, uv + vec2(-texel.x, -texel.y)).rgb,
+        texture(source, uv + vec2(0.0, -texel.y)).rgb,
+        texture(source, uv + vec2(texel.x, -texel.y)).rgb,
+        texture(source, uv + vec2(-texel.x, 0.0)).rgb,
+        texture(source, uv + vec2(texel.x, 0.0)).rgb,
+        texture(source, uv + vec2(-texel.x, texel.y)).rgb,
+        texture(source, uv + vec2(0.0, texel.y)).rgb,
+        texture(source, uv + vec2(texel.x, texel.y)).rgb);
+}
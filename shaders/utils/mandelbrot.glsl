@@ -0,0 +1,134 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+// no version indication here it will be included and not used as its own
+
+// Shared by the fragment and compute Mandelbrot shaders, which declare resolution, offset, zoom,
+// show_glow, max_iterations, use_tile_budget, tile_budget, gradient_texture and gradient_row.
+
+float get_iteration_budget(vec2 frag_coord) 
+{
+    if (!use_tile_budget) return max_iterations;
+    return textureLod(tile_budget, frag_coord / resolution, 0.0).r;
+}
+
+// Gradients are interpolated in OKLab once on the CPU, one row of the texture each
+vec3 gradient_color(float t)
+{
+    float width = float(textureSize(gradient_texture, 0).x);
+    return textureLod(gradient_texture, vec2((clamp(t, 0.0, 1.0) * (width - 1.0) + 0.5) / width, gradient_row), 0.0).rgb;
+}
+
+vec3 get_color_and_glow(vec2 z, float de, float iter, float max_iter) 
+{
+    if(iter >= max_iter) return vec3(0.0);
+    
+    // Smooth iteration count
+    float log_zn = log(length(z)) / 2.0;
+    float nu = log(log_zn / log(2.0)) / log(2.0);
+    float smoothed = iter + 1.0 - nu;
+    float normalized = smoothed / max_iter;
+    
+    vec3 base_color_oklab = gradient_color(normalized);
+
+    // Add glow based on distance estimation
+    float glow_intensity = 1.0 / (de * 2.0);            // Reduced multiplication factor for stronger effect
+    glow_intensity = pow(glow_intensity, 1.5);          // Adjust power for stronger falloff
+    glow_intensity = clamp(glow_intensity, 0.0, 5.0);   // Allow for overbright glow
+
+    // Create multiple layers of glow with different colors
+    float inner_glow = smoothstep(0.0, 1.0, glow_intensity);
+    float mid_glow = smoothstep(0.2, 0.8, glow_intensity);
+    float outer_glow = smoothstep(0.4, 0.6, glow_intensity);
+
+    // Define more vibrant glow colors
+    vec3 inner_color = vec3(1.0, 0.3, 0.1);    // Bright orange-red
+    vec3 mid_color = vec3(1.0, 0.8, 0.2);      // Bright yellow
+    vec3 outer_color = vec3(0.2, 0.5, 1.0);    // Bright blue
+    
+    float t = iter / max_iter;
+    vec3 base_color_rgb  = vec3(t * 0.5, t, t * 0.7);
+
+    // Combine all glow layers
+    vec3 col = base_color_oklab;
+
+    if (!show_glow) 
+    {
+        return col;
+    }
+    
+    col = mix(col, outer_color, outer_glow * 0.8);
+    col = mix(col, mid_color, mid_glow * 0.6);
+    col = mix(col, inner_color, inner_glow * 0.4);
+
+    // Add brightness boost
+    col *= (1.0 + glow_intensity * 0.5);
+
+    return col;
+}
+
+float iterate(vec2 c, float max_iter, out vec2 z, out float dr, out bool escaped)
+{
+    vec2 dz = vec2(1.0, 0.0);
+    vec2 sum_dz = vec2(0.0);
+    float iter = 0.0;
+    float dbail = 1e6;
+
+    z = vec2(0.0);
+    dr = 1.0;
+    escaped = false;
+    
+    for(float i = 0.0; i < max_iter; i++) 
+    {
+        dr = 2.0 * length(z) * dr;
+        z = vec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + c;
+        dz = vec2(z.x * dz.x - z.y * dz.y + 1.0, z.x * dz.y + dz.x * z.y);
+        sum_dz += dz;
+        if(dot(sum_dz, sum_dz) > dbail) {
+            iter = i;
+            escaped = true;
+            break;
+        }
+    }
+
+    return iter;
+}
+
+vec3 fractal(vec2 uv, float max_iter)
+{
+    vec2 z;
+    float dr;
+    bool escaped;
+    float iter = iterate(uv, max_iter, z, dr, escaped);
+
+    // Calculate distance estimation
+    float mod_z = length(z);
+    float de = 2.0 * mod_z * log(mod_z) / dr;
+
+    // colors are normalized by the frame budget so per tile budgets leave no seams
+    vec3 color = get_color_and_glow(z, de, iter, max_iterations);
+
+    return color;
+}
+
+vec2 pixel_to_complex(vec2 frag_coord)
+{
+    vec2 uv = (frag_coord / resolution.xy) * 4.0 - vec2(2.0);
+    uv.x *= resolution.x / resolution.y;
+    return uv / zoom + offset;  // Apply zoom and pan
+}
+
+vec3 shade_pixel(vec2 frag_coord)
+{
+    vec2 uv = pixel_to_complex(frag_coord);
+
+    float MAX_ITER = get_iteration_budget(frag_coord);
+    vec3 color = fractal(uv, MAX_ITER);
+
+    // Add post-processing effects
+    color = pow(color, vec3(0.8));     // Gamma correction
+    color *= 1.2;                      // Brightness boost
+
+    return color;
+}
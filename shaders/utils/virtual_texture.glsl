@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+// no version indication here it will be included and not used as its own
+
+uniform vec2 resolution;
+uniform float zoom;
+uniform vec2 offset;
+uniform usampler2D page_table;     // one mip per level, xy slot of the page and z its resident level
+uniform sampler2D page_cache;       // pages and their borders, side by side
+uniform vec2 image_size;
+uniform int page_levels;
+uniform float page_size;
+uniform float page_border;
+uniform float cache_size;
+
+// Texel of the image under a pixel, the image fits the window at zoom 1
+// and pans with the same view coordinates as the Mandelbrot
+vec2 image_position(vec2 frag_coord)
+{
+    vec2 view = (frag_coord / resolution) * 4.0 - vec2(2.0);
+    view.x *= resolution.x / resolution.y;
+    view = view / zoom + offset;
+
+    float fit = min(resolution.x / image_size.x, resolution.y / image_size.y);
+    vec2 position = view * 0.25 * resolution.y / fit;
+    return vec2(0.5 * image_size.x + position.x, 0.5 * image_size.y - position.y);
+}
+
+bool inside_image(vec2 position)
+{
+    return all(greaterThanEqual(position, vec2(0.0))) && all(lessThan(position, image_size));
+}
+
+// Level of the pyramid where a texel is about a pixel
+int image_level(vec2 position, float bias)
+{
+    vec2 dx = dFdx(position);
+    vec2 dy = dFdy(position);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + bias;
+    return int(clamp(floor(lod), 0.0, float(page_levels - 1)));
+}
+
+ivec2 image_page(vec2 position, int level)
+{
+    return ivec2(position / (page_size * exp2(float(level))));
+}
+
+// The page table entry of a missing page holds its closest resident
+// ancestor, whose page is found again from the position at that level
+vec4 sample_virtual(vec2 position, int level)
+{
+    uvec4 entry = texelFetch(page_table, image_page(position, level), level);
+    vec2 texel = position / exp2(float(entry.z));
+    vec2 inside = texel - floor(texel / page_size) * page_size;
+    vec2 slot = vec2(entry.xy) * (page_size + 2.0 * page_border);
+    return textureLod(page_cache, (slot + vec2(page_border) + inside) / cache_size, 0.0);
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+layout (location = 1) in vec4 parent;   // start.xy end.xy of the parent branch, one per instance
+
+uniform int level;
+uniform int depth;
+uniform float time;
+uniform float branch_angle;
+uniform float branch_length;
+uniform float decay;
+uniform float sway;
+uniform vec2 trunk;
+
+out vec4 child;             // captured by transform feedback, two children per parent
+
+#define PI 3.14159265
+#define SWAY_SPEED 1.5
+#define BREATH_SPEED 0.7
+#define BREATH_AMPLITUDE 0.15
+
+void main()
+{
+    float side = gl_VertexID == 0 ? -1.0 : 1.0;
+    vec2 start;
+    float angle;
+    float size;
+
+    if (level == 0)
+    {
+        // both trunk branches part with the wind
+        start = trunk;
+        angle = PI / 2.0 + side * sway * sin(time * SWAY_SPEED);
+        size = branch_length;
+    }
+    else
+    {
+        // same rule as the CPU generation, the angle breathes and every branch
+        // sways with its own phase, more and more towards the tips
+        float phase = float(gl_InstanceID * 2 + gl_VertexID) * 0.37 + float(level);
+        float variation = float(level - 1) * branch_angle * (1.0 + BREATH_AMPLITUDE * sin(time * BREATH_SPEED));
+        float parent_angle = atan(parent.w - parent.y, parent.z - parent.x);
+
+        start = parent.zw;
+        angle = parent_angle + side * variation + sway * float(level) / float(depth) * sin(time * SWAY_SPEED + phase);
+        size = branch_length * pow(decay, float(level - 1));
+    }
+
+    child = vec4(start, start + vec2(cos(angle), sin(angle)) * size);
+}
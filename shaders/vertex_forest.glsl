@@ -0,0 +1,42 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+uniform samplerBuffer segments;  // template branches, start.xy end.xy from the trunk base
+uniform samplerBuffer trees;     // visible trees, position.xy scale flip
+uniform int template_start;      // first branch of the drawn template
+uniform int template_count;      // its number of branches
+uniform int tree_start;          // first visible tree using the template
+
+uniform vec2 resolution;
+uniform vec2 offset;
+uniform float zoom;
+uniform float thickness;
+
+out vec2 local;             // position in the branch frame, x along and y across
+flat out float branch_length;
+
+void main()
+{
+    // one instance per branch of every tree, the quad corners come from the vertex id
+    vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) * 2 - 1);
+    vec4 tree = texelFetch(trees, tree_start + gl_InstanceID / template_count);
+    vec4 segment = texelFetch(segments, template_start + gl_InstanceID % template_count);
+
+    vec2 scale = vec2(tree.z * tree.w, tree.z);
+    vec2 a = tree.xy + segment.xy * scale;
+    vec2 ba = segment.zw * scale - segment.xy * scale;
+    branch_length = length(ba);
+    vec2 direction = branch_length > 0.0 ? ba / branch_length : vec2(1.0, 0.0);
+    vec2 normal = vec2(-direction.y, direction.x);
+
+    // same view as the Mandelbrot, the screen height spans 4 / zoom
+    float pixel = 4.0 / (zoom * resolution.y);
+    float radius = 2.0 * thickness + pixel;
+    local = vec2(mix(-radius, branch_length + radius, corner.x), corner.y * radius);
+
+    vec2 p = a + direction * local.x + normal * local.y;
+    float aspect = resolution.x / resolution.y;
+    gl_Position = vec4((p - offset) * zoom / vec2(2.0 * aspect, 2.0), 0.0, 1.0);
+}
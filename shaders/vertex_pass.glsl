@@ -0,0 +1,15 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+layout (location = 0) in vec2 position;
+
+out vec2 TexCoord;
+
+void main()
+{
+    // full screen pass of a render graph, over the quad of the procedural generators
+    gl_Position = vec4(position, 0.0, 1.0);
+    TexCoord = position * 0.5 + 0.5;
+}
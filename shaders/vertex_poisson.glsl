@@ -0,0 +1,27 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+layout (location = 0) in vec2 corner;
+layout (location = 1) in vec3 point;    // position.xy radius, one sprite per instance
+
+uniform vec2 resolution;
+uniform vec2 offset;
+uniform float zoom;
+uniform float dot_scale;
+
+out vec2 local;
+flat out float dot_radius;
+
+void main()
+{
+    // same view as the Mandelbrot, the screen height spans 4 / zoom
+    float pixel = 4.0 / (zoom * resolution.y);
+    dot_radius = point.z * dot_scale;
+    local = corner * (dot_radius + pixel);
+
+    vec2 p = point.xy + local;
+    float aspect = resolution.x / resolution.y;
+    gl_Position = vec4((p - offset) * zoom / vec2(2.0 * aspect, 2.0), 0.0, 1.0);
+}
@@ -0,0 +1,34 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+layout (location = 0) in vec2 corner;    // (0 or 1 along the branch, -1 or 1 across)
+layout (location = 1) in vec4 segment;   // start.xy end.xy, one branch per instance
+
+uniform vec2 resolution;
+uniform float thickness;
+uniform vec4 transform;     // scale.xy offset.xy applied to the segments
+
+out vec2 local;             // position in the branch frame, x along and y across
+flat out float branch_length;
+
+void main()
+{
+    // same mapping as the fullscreen canopy, p = (uv * 2 - 1) * aspect
+    float aspect = resolution.x / resolution.y;
+    vec2 pixel = 2.0 * aspect / resolution;
+
+    vec2 a = segment.xy * transform.xy + transform.zw;
+    vec2 ba = segment.zw * transform.xy + transform.zw - a;
+    branch_length = length(ba);
+    vec2 direction = branch_length > 0.0 ? ba / branch_length : vec2(1.0, 0.0);
+    vec2 normal = vec2(-direction.y, direction.x);
+
+    // the outline reaches 2 * thickness, plus a pixel for the anti-aliased edge
+    float radius = 2.0 * thickness + max(pixel.x, pixel.y);
+    local = vec2(mix(-radius, branch_length + radius, corner.x), corner.y * radius);
+
+    vec2 p = a + direction * local.x + normal * local.y;
+    gl_Position = vec4(p / aspect, 0.0, 1.0);
+}
@@ -0,0 +1,21 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#version 330 core
+layout (location = 0) in vec2 seed;
+
+uniform vec2 offset;
+uniform float pixel_scale;
+uniform vec2 center;
+uniform vec2 field_size;
+
+flat out int seed_id;
+
+void main()
+{
+    // one point per seed, in the field pixel under it
+    seed_id = gl_VertexID;
+    vec2 pixel = (seed - offset) * pixel_scale + center;
+    gl_Position = vec4(pixel / field_size * 2.0 - 1.0, 0.0, 1.0);
+}
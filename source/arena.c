@@ -0,0 +1,45 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/arena.h"
+
+int init_arena(arena_t* arena, size_t size)
+{
+    arena->base = (unsigned char*)malloc(size);
+    if (!arena->base) return PG_ALLOCATION_ERROR;
+
+    arena->size = size;
+    arena->used = 0;
+    return PG_SUCCESS;
+}
+
+// Allocations are never freed one by one, the arena has a fixed capacity
+int arena_alloc(arena_t* arena, size_t size, void** p)
+{
+    size_t start = (arena->used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (start > arena->size || size > arena->size - start) return PG_INSUFFICIENT_MEMORY;
+
+    *p = arena->base + start;
+    arena->used = start + size;
+    return PG_SUCCESS;
+}
+
+size_t arena_mark(const arena_t* arena)
+{
+    return arena->used;
+}
+
+// Release everything allocated since the mark was taken
+void arena_reset(arena_t* arena, size_t mark)
+{
+    arena->used = mark;
+}
+
+void free_arena(arena_t* arena)
+{
+    free(arena->base);
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
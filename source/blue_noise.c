@@ -0,0 +1,485 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/blue_noise.h"
+
+#define KERNEL_SIDE (2 * BLUE_NOISE_RADIUS + 1)
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+// Void-and-cluster state over a torus. The energy of a pixel is the set pixels around
+// it weighted by a Gaussian. Blocks keep their densest set pixel and their emptiest
+// unset one, a toggle only rescans the blocks its kernel touched.
+typedef struct void_cluster_s
+{
+    int size;
+    int blocks;
+    uint8_t* pattern;
+    double* energy;
+    double kernel[KERNEL_SIDE * KERNEL_SIDE];
+    double* spectrum_re;        // kernel wrapped over the torus, in the frequency domain
+    double* spectrum_im;
+    double* work_re;
+    double* work_im;
+    int* cluster;
+    int* hole;
+} void_cluster_t;
+
+// In place radix-2 FFT of n complex values, n a power of two
+static void fft(double* re, double* im, int n, int inverse)
+{
+    for (int i = 1, j = 0; i < n; i++)
+    {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+        {
+            double swap = re[i];
+            re[i] = re[j];
+            re[j] = swap;
+            swap = im[i];
+            im[i] = im[j];
+            im[j] = swap;
+        }
+    }
+
+    for (int length = 2; length <= n; length <<= 1)
+    {
+        double angle = (inverse ? 2.0 : -2.0) * M_PI / length;
+        double step_re = cos(angle);
+        double step_im = sin(angle);
+
+        for (int i = 0; i < n; i += length)
+        {
+            double w_re = 1.0;
+            double w_im = 0.0;
+            for (int k = 0; k < length / 2; k++)
+            {
+                int a = i + k;
+                int b = a + length / 2;
+                double t_re = re[b] * w_re - im[b] * w_im;
+                double t_im = re[b] * w_im + im[b] * w_re;
+                re[b] = re[a] - t_re;
+                im[b] = im[a] - t_im;
+                re[a] += t_re;
+                im[a] += t_im;
+
+                double next = w_re * step_re - w_im * step_im;
+                w_im = w_re * step_im + w_im * step_re;
+                w_re = next;
+            }
+        }
+    }
+
+    if (inverse)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            re[i] /= n;
+            im[i] /= n;
+        }
+    }
+}
+
+// Rows then columns, columns are gathered so every transform is contiguous
+static int fft_2d(double* re, double* im, int n, int inverse)
+{
+    double* column = (double*)malloc(2 * (size_t)n * sizeof(double));
+    if (!column) return PG_ALLOCATION_ERROR;
+
+    for (int y = 0; y < n; y++)
+    {
+        fft(re + (size_t)y * n, im + (size_t)y * n, n, inverse);
+    }
+
+    for (int x = 0; x < n; x++)
+    {
+        for (int y = 0; y < n; y++)
+        {
+            column[y] = re[(size_t)y * n + x];
+            column[n + y] = im[(size_t)y * n + x];
+        }
+        fft(column, column + n, n, inverse);
+        for (int y = 0; y < n; y++)
+        {
+            re[(size_t)y * n + x] = column[y];
+            im[(size_t)y * n + x] = column[n + y];
+        }
+    }
+
+    free(column);
+    return PG_SUCCESS;
+}
+
+static void rescan_block(void_cluster_t* vc, int block)
+{
+    int x0 = block % vc->blocks * BLUE_NOISE_BLOCK;
+    int y0 = block / vc->blocks * BLUE_NOISE_BLOCK;
+    int cluster = -1;
+    int hole = -1;
+
+    for (int y = y0; y < y0 + BLUE_NOISE_BLOCK; y++)
+    {
+        for (int x = x0; x < x0 + BLUE_NOISE_BLOCK; x++)
+        {
+            int i = y * vc->size + x;
+            if (vc->pattern[i])
+            {
+                if (cluster < 0 || vc->energy[i] > vc->energy[cluster]) cluster = i;
+            }
+            else if (hole < 0 || vc->energy[i] < vc->energy[hole])
+            {
+                hole = i;
+            }
+        }
+    }
+
+    vc->cluster[block] = cluster;
+    vc->hole[block] = hole;
+}
+
+// Energy of the whole pattern from scratch, as a product in the frequency domain.
+// Toggles then keep it up to date, this also clears their rounding drift.
+static int compute_energy(void_cluster_t* vc)
+{
+    int last_status = PG_SUCCESS;
+    size_t count = (size_t)vc->size * vc->size;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        vc->work_re[i] = vc->pattern[i];
+        vc->work_im[i] = 0.0;
+    }
+
+    CHECK_CALL(fft_2d, vc->work_re, vc->work_im, vc->size, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        double re = vc->work_re[i] * vc->spectrum_re[i] - vc->work_im[i] * vc->spectrum_im[i];
+        double im = vc->work_re[i] * vc->spectrum_im[i] + vc->work_im[i] * vc->spectrum_re[i];
+        vc->work_re[i] = re;
+        vc->work_im[i] = im;
+    }
+    CHECK_CALL(fft_2d, vc->work_re, vc->work_im, vc->size, 1);
+
+    memcpy(vc->energy, vc->work_re, count * sizeof(double));
+    for (int block = 0; block < vc->blocks * vc->blocks; block++)
+    {
+        rescan_block(vc, block);
+    }
+
+    return last_status;
+}
+
+static void toggle(void_cluster_t* vc, int pixel, int value)
+{
+    int mask = vc->size - 1;
+    int px = pixel % vc->size;
+    int py = pixel / vc->size;
+    double sign = value ? 1.0 : -1.0;
+
+    vc->pattern[pixel] = (uint8_t)value;
+    for (int dy = -BLUE_NOISE_RADIUS; dy <= BLUE_NOISE_RADIUS; dy++)
+    {
+        double* row = vc->energy + (size_t)((py + dy) & mask) * vc->size;
+        const double* weights = vc->kernel + (dy + BLUE_NOISE_RADIUS) * KERNEL_SIDE + BLUE_NOISE_RADIUS;
+        for (int dx = -BLUE_NOISE_RADIUS; dx <= BLUE_NOISE_RADIUS; dx++)
+        {
+            row[(px + dx) & mask] += sign * weights[dx];
+        }
+    }
+
+    // the kernel radius is smaller than a block, it touches at most two blocks along each axis
+    int bx[2] = { ((px - BLUE_NOISE_RADIUS) & mask) / BLUE_NOISE_BLOCK, ((px + BLUE_NOISE_RADIUS) & mask) / BLUE_NOISE_BLOCK };
+    int by[2] = { ((py - BLUE_NOISE_RADIUS) & mask) / BLUE_NOISE_BLOCK, ((py + BLUE_NOISE_RADIUS) & mask) / BLUE_NOISE_BLOCK };
+    int nx = bx[0] == bx[1] ? 1 : 2;
+    int ny = by[0] == by[1] ? 1 : 2;
+    for (int j = 0; j < ny; j++)
+    {
+        for (int i = 0; i < nx; i++)
+        {
+            rescan_block(vc, by[j] * vc->blocks + bx[i]);
+        }
+    }
+}
+
+// Set pixel of highest energy
+static int tightest_cluster(const void_cluster_t* vc)
+{
+    int best = -1;
+    for (int block = 0; block < vc->blocks * vc->blocks; block++)
+    {
+        int pixel = vc->cluster[block];
+        if (pixel >= 0 && (best < 0 || vc->energy[pixel] > vc->energy[best])) best = pixel;
+    }
+    return best;
+}
+
+// Unset pixel of lowest energy
+static int largest_void(const void_cluster_t* vc)
+{
+    int best = -1;
+    for (int block = 0; block < vc->blocks * vc->blocks; block++)
+    {
+        int pixel = vc->hole[block];
+        if (pixel >= 0 && (best < 0 || vc->energy[pixel] < vc->energy[best])) best = pixel;
+    }
+    return best;
+}
+
+static void free_void_cluster(void_cluster_t* vc)
+{
+    free(vc->pattern);
+    free(vc->energy);
+    free(vc->spectrum_re);
+    free(vc->spectrum_im);
+    free(vc->work_re);
+    free(vc->work_im);
+    free(vc->cluster);
+    free(vc->hole);
+}
+
+static int init_void_cluster(void_cluster_t* vc, int size)
+{
+    int last_status = PG_SUCCESS;
+    size_t count = (size_t)size * size;
+
+    vc->size = size;
+    vc->blocks = size / BLUE_NOISE_BLOCK;
+    vc->pattern = (uint8_t*)calloc(count, sizeof(uint8_t));
+    vc->energy = (double*)calloc(count, sizeof(double));
+    vc->spectrum_re = (double*)calloc(count, sizeof(double));
+    vc->spectrum_im = (double*)calloc(count, sizeof(double));
+    vc->work_re = (double*)calloc(count, sizeof(double));
+    vc->work_im = (double*)calloc(count, sizeof(double));
+    vc->cluster = (int*)calloc((size_t)vc->blocks * vc->blocks, sizeof(int));
+    vc->hole = (int*)calloc((size_t)vc->blocks * vc->blocks, sizeof(int));
+    if (!vc->pattern || !vc->energy || !vc->spectrum_re || !vc->spectrum_im ||
+        !vc->work_re || !vc->work_im || !vc->cluster || !vc->hole)
+    {
+        return PG_ALLOCATION_ERROR;
+    }
+
+    for (int dy = -BLUE_NOISE_RADIUS; dy <= BLUE_NOISE_RADIUS; dy++)
+    {
+        for (int dx = -BLUE_NOISE_RADIUS; dx <= BLUE_NOISE_RADIUS; dx++)
+        {
+            double weight = exp(-(dx * dx + dy * dy) / (2.0 * BLUE_NOISE_SIGMA * BLUE_NOISE_SIGMA));
+            vc->kernel[(dy + BLUE_NOISE_RADIUS) * KERNEL_SIDE + dx + BLUE_NOISE_RADIUS] = weight;
+            vc->spectrum_re[(size_t)((dy + size) & (size - 1)) * size + ((dx + size) & (size - 1))] = weight;
+        }
+    }
+    CHECK_CALL(fft_2d, vc->spectrum_re, vc->spectrum_im, size, 0);
+
+    return last_status;
+}
+
+static int void_and_cluster(void_cluster_t* vc, int* ranks)
+{
+    int last_status = PG_SUCCESS;
+    int count = vc->size * vc->size;
+    int ones = (int)(BLUE_NOISE_FRACTION * count);
+
+    // prototype pattern, a few random pixels
+    uint32_t random_state = BLUE_NOISE_SEED;
+    for (int placed = 0; placed < ones;)
+    {
+        int pixel = (int)(random_float(&random_state) * count);
+        if (vc->pattern[pixel]) continue;
+        vc->pattern[pixel] = 1;
+        placed++;
+    }
+    CHECK_CALL(compute_energy, vc);
+
+    // spread it, the tightest cluster moves to the largest void until it would stay put
+    for (int moves = 0; moves < count; moves++)
+    {
+        int cluster = tightest_cluster(vc);
+        toggle(vc, cluster, 0);
+        int hole = largest_void(vc);
+        toggle(vc, hole, 1);
+        if (hole == cluster) break;
+    }
+
+    uint8_t* prototype = (uint8_t*)malloc((size_t)count);
+    if (!prototype) return PG_ALLOCATION_ERROR;
+    memcpy(prototype, vc->pattern, (size_t)count);
+
+    // ranks below the prototype, removing the tightest clusters first
+    last_status = compute_energy(vc);
+    for (int rank = ones - 1; rank >= 0 && !last_status; rank--)
+    {
+        int cluster = tightest_cluster(vc);
+        toggle(vc, cluster, 0);
+        ranks[cluster] = rank;
+    }
+
+    // ranks above, filling the largest voids. Past half the pixels the original method
+    // inverts the pattern and removes clusters of unset pixels, with an energy linear in
+    // the pattern that picks the very same pixels, so the second half needs nothing else.
+    memcpy(vc->pattern, prototype, (size_t)count);
+    free(prototype);
+    if (!last_status) last_status = compute_energy(vc);
+    for (int rank = ones; rank < count && !last_status; rank++)
+    {
+        int hole = largest_void(vc);
+        toggle(vc, hole, 1);
+        ranks[hole] = rank;
+    }
+
+    return last_status;
+}
+
+// Threshold mask of the given size, a power of two, every value equally represented
+int generate_blue_noise(int size, uint8_t** p_mask)
+{
+    int last_status = PG_SUCCESS;
+
+    if (size < 2 * BLUE_NOISE_BLOCK || size < KERNEL_SIDE || (size & (size - 1))) return PG_INVALID_PARAMETER;
+
+    size_t count = (size_t)size * size;
+    void_cluster_t vc = { 0 };
+    int* ranks = (int*)malloc(count * sizeof(int));
+    uint8_t* mask = (uint8_t*)malloc(count);
+    if (!ranks || !mask)
+    {
+        free(ranks);
+        free(mask);
+        return PG_ALLOCATION_ERROR;
+    }
+
+    last_status = init_void_cluster(&vc, size);
+    if (!last_status) last_status = void_and_cluster(&vc, ranks);
+    free_void_cluster(&vc);
+    if (last_status)
+    {
+        free(ranks);
+        free(mask);
+        return last_status;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        mask[i] = (uint8_t)((uint64_t)ranks[i] * 256 / count);
+    }
+    free(ranks);
+
+    *p_mask = mask;
+    return last_status;
+}
+
+static uint64_t fnv1a(const void* data, size_t length, uint64_t hash)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// The cache file is named after everything the mask depends on,
+// and holds a checksum of the mask to catch damaged files
+static uint64_t cache_key(int size)
+{
+    char description[160];
+    snprintf(description, sizeof(description), "void-and-cluster %d size %d sigma %.4f radius %d fraction %.4f seed %08x",
+        BLUE_NOISE_VERSION, size, BLUE_NOISE_SIGMA, BLUE_NOISE_RADIUS, BLUE_NOISE_FRACTION, BLUE_NOISE_SEED);
+    return fnv1a(description, strlen(description), FNV_OFFSET);
+}
+
+static int read_cache(const char* path, int size, uint8_t** p_mask)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return PG_NOT_FOUND;
+
+    size_t count = (size_t)size * size;
+    uint32_t header[2] = { 0, 0 };
+    uint64_t checksum = 0;
+    uint8_t* mask = (uint8_t*)malloc(count);
+    int complete = mask &&
+        fread(header, sizeof(header), 1, file) == 1 &&
+        fread(&checksum, sizeof(checksum), 1, file) == 1 &&
+        fread(mask, 1, count, file) == count;
+    fclose(file);
+
+    if (!complete || header[0] != BLUE_NOISE_MAGIC || header[1] != (uint32_t)size ||
+        fnv1a(mask, count, FNV_OFFSET) != checksum)
+    {
+        fprintf(stderr, "Ignoring damaged blue noise cache %s\n", path);
+        free(mask);
+        return PG_UNREADABLE_FILE;
+    }
+
+    *p_mask = mask;
+    return PG_SUCCESS;
+}
+
+static int write_cache(const char* path, int size, const uint8_t* mask)
+{
+#ifdef _WIN32
+    _mkdir(BLUE_NOISE_CACHE_DIR);
+#else
+    mkdir(BLUE_NOISE_CACHE_DIR, 0755);
+#endif
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return PG_ACCESS_DENIED;
+
+    size_t count = (size_t)size * size;
+    uint32_t header[2] = { BLUE_NOISE_MAGIC, (uint32_t)size };
+    uint64_t checksum = fnv1a(mask, count, FNV_OFFSET);
+    int complete =
+        fwrite(header, sizeof(header), 1, file) == 1 &&
+        fwrite(&checksum, sizeof(checksum), 1, file) == 1 &&
+        fwrite(mask, 1, count, file) == count;
+    fclose(file);
+
+    return complete ? PG_SUCCESS : PG_EXTERNAL_ERROR;
+}
+
+// Blue noise threshold texture, read from the cache or generated then cached
+int load_blue_noise(int size, GLuint* p_texture)
+{
+    int last_status = PG_SUCCESS;
+
+    char path[64];
+    snprintf(path, sizeof(path), BLUE_NOISE_CACHE_DIR "/blue_noise_%016llx.bin", (unsigned long long)cache_key(size));
+
+    uint8_t* mask = NULL;
+    if (read_cache(path, size, &mask))
+    {
+        double start = glfwGetTime();
+        CHECK_CALL(generate_blue_noise, size, &mask);
+        printf("[>] Blue noise %dx%d generated in %.2f s\n", size, size, glfwGetTime() - start);
+
+        // a missing cache only costs the generation next time
+        if (write_cache(path, size, mask))
+        {
+            fprintf(stderr, "Cannot write blue noise cache %s\n", path);
+        }
+    }
+    else
+    {
+        printf("[>] Blue noise %dx%d loaded from %s\n", size, size, path);
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, mask);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(mask);
+
+    *p_texture = texture;
+
+    return last_status;
+}
@@ -5,6 +5,8 @@
 #include "../include/callbacks.h"
 #include "../include/structs.h"
 #include "../include/utils_macro.h"
+#include "../include/canopy.h"
+#include "../include/jump_flood.h"
 
 void error_callback(int error, const char* description) 
 {
@@ -49,6 +51,8 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     // Adjust offset to keep mouse position fixed
     data->offset[0] += mouse_world_x - newMouseWorldX;
     data->offset[1] += mouse_world_y - newMouseWorldY;
+
+    data->last_interaction = glfwGetTime();
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
@@ -85,5 +89,83 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
         
         data->last_x = xpos;
         data->last_y = ypos;
+
+        data->last_interaction = glfwGetTime();
     }
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    UNREFERENCED_PARAMETER(scancode);
+    UNREFERENCED_PARAMETER(mods);
+    state_t* data = (state_t*)glfwGetWindowUserPointer(window);
+
+    if (action != GLFW_PRESS) return;
+
+    switch (key)
+    {
+        case GLFW_KEY_R:
+            data->dynamic_resolution = !data->dynamic_resolution;
+            printf("[>] Dynamic resolution %s.\n", data->dynamic_resolution ? "enabled" : "disabled");
+            break;
+
+        case GLFW_KEY_C:
+            data->checkerboard = !data->checkerboard;
+            printf("[>] Checkerboard rendering %s.\n", data->checkerboard ? "enabled" : "disabled");
+            break;
+
+        case GLFW_KEY_B:
+            data->compute_backend = !data->compute_backend;
+            printf("[>] Mandelbrot %s backend selected.\n", data->compute_backend ? "compute" : "fragment");
+            break;
+
+        case GLFW_KEY_M:
+            data->symmetry = !data->symmetry;
+            printf("[>] Real axis symmetry %s.\n", data->symmetry ? "enabled" : "disabled");
+            break;
+
+        case GLFW_KEY_Q:
+            data->canopy_raster = !data->canopy_raster;
+            printf("[>] Canopy %s renderer selected.\n", data->canopy_raster ? "rasterized" : "distance field");
+            break;
+
+        case GLFW_KEY_A:
+            data->canopy_animate = !data->canopy_animate;
+            printf("[>] Canopy animation %s.\n", data->canopy_animate ? "enabled" : "disabled");
+            break;
+
+        case GLFW_KEY_E:
+            data->distance_effect = (data->distance_effect + 1) % EFFECT_COUNT;
+            printf("[>] Distance effect: %s.\n", distance_effect_name(data->distance_effect));
+            break;
+
+        case GLFW_KEY_G:
+            if (data->gradient_count) data->gradient = (data->gradient + 1) % data->gradient_count;
+            break;
+
+        case GLFW_KEY_P:
+            data->postprocess = !data->postprocess;
+            printf("[>] Post-processing of procedural generators %s.\n", data->postprocess ? "enabled" : "disabled");
+            break;
+
+        case GLFW_KEY_UP:
+        case GLFW_KEY_DOWN:
+            data->canopy.depth += (key == GLFW_KEY_UP) ? 1 : -1;
+            if (data->canopy.depth < CANOPY_MIN_DEPTH) data->canopy.depth = CANOPY_MIN_DEPTH;
+            if (data->canopy.depth > CANOPY_MAX_DEPTH) data->canopy.depth = CANOPY_MAX_DEPTH;
+            break;
+
+        case GLFW_KEY_LEFT:
+        case GLFW_KEY_RIGHT:
+            data->canopy.branch_angle += (key == GLFW_KEY_RIGHT) ? CANOPY_ANGLE_STEP : -CANOPY_ANGLE_STEP;
+            break;
+
+        default:
+            break;
+    }
+}
+
+int is_interacting(const state_t* data)
+{
+    return data->is_dragging || (glfwGetTime() - data->last_interaction) < INTERACTION_IDLE_DELAY;
 }
\ No newline at end of file
@@ -0,0 +1,366 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/canopy.h"
+
+void init_canopy_params(canopy_params_t* params)
+{
+    params->thickness = 0.005f;
+    params->branch_angle = M_PI / 6.0f;
+    params->branch_length = 0.5f;
+    params->decay = 0.5f;
+    params->depth = 8;
+}
+
+int init_canopy(canopy_t* canopy)
+{
+    int last_status = PG_SUCCESS;
+
+    glGenBuffers(1, &canopy->buffer);
+    glGenTextures(1, &canopy->texture);
+    glGenBuffers(1, &canopy->cell_buffer);
+    glGenTextures(1, &canopy->cell_texture);
+    glGenBuffers(1, &canopy->index_buffer);
+    glGenTextures(1, &canopy->index_texture);
+    canopy->segments = NULL;
+    canopy->segment_count = 0;
+
+    CHECK_CALL(create_program, "shaders/vertex_segment.glsl", "shaders/fragment_segment.glsl", &canopy->raster_program);
+
+    CHECK_CALL(init_segment_renderer, &canopy->raster, canopy->buffer);
+
+    CHECK_CALL(create_feedback_program, "shaders/vertex_canopy_feedback.glsl", "child", &canopy->feedback_program);
+    glGenVertexArrays(1, &canopy->feedback_vao);
+    glGenBuffers(1, &canopy->animated_buffer);
+    glGenBuffers(1, &canopy->feedback_buffer);
+    canopy->animated_depth = 0;
+    CHECK_CALL(init_segment_renderer, &canopy->animated, canopy->animated_buffer);
+
+    return last_status;
+}
+
+// Binary tree of depth levels: level 0 holds the two trunk branches,
+// level i + 1 splits each branch of level i by +/- i * branch_angle
+// with a length of branch_length * decay^i. Levels are stored one after the other.
+int generate_canopy_segments(const canopy_params_t* params, float** p_segments, int* p_count)
+{
+    int count = (1 << (params->depth + 1)) - 2;
+    float* segments = (float*)malloc((size_t)count * 4 * sizeof(float));
+    if (!segments) return PG_ALLOCATION_ERROR;
+
+    float base_angle = M_PI / 2.0f;
+    for (int k = 0; k < 2; k++)
+    {
+        segments[4 * k + 0] = CANOPY_TRUNK_X;
+        segments[4 * k + 1] = CANOPY_TRUNK_Y;
+        segments[4 * k + 2] = CANOPY_TRUNK_X + cosf(base_angle) * params->branch_length;
+        segments[4 * k + 3] = CANOPY_TRUNK_Y + sinf(base_angle) * params->branch_length;
+    }
+
+    int parent_start = 0;
+    int parent_count = 2;
+    for (int level = 0; level < params->depth - 1; level++)
+    {
+        float variation = level * params->branch_angle;
+        float length = params->branch_length * powf(params->decay, (float)level);
+        int child = parent_start + parent_count;
+
+        for (int j = parent_start; j < parent_start + parent_count; j++)
+        {
+            const float* parent = segments + 4 * j;
+            float parent_angle = atan2f(parent[3] - parent[1], parent[2] - parent[0]);
+
+            for (int side = -1; side <= 1; side += 2)
+            {
+                float angle = parent_angle + side * variation;
+                float* out = segments + 4 * child++;
+                out[0] = parent[2];
+                out[1] = parent[3];
+                out[2] = parent[2] + cosf(angle) * length;
+                out[3] = parent[3] + sinf(angle) * length;
+            }
+        }
+
+        parent_start += parent_count;
+        parent_count *= 2;
+    }
+
+    *p_segments = segments;
+    *p_count = count;
+    return PG_SUCCESS;
+}
+
+static void upload_buffer_texture(GLuint buffer, GLuint texture, GLenum format, GLsizeiptr size, const void* content)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, content, GL_STATIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+static void cell_range(const canopy_t* canopy, float lo, float hi, int axis, int* first, int* last)
+{
+    *first = (int)floorf((lo - canopy->grid_origin[axis]) / canopy->grid_cell_size);
+    *last = (int)floorf((hi - canopy->grid_origin[axis]) / canopy->grid_cell_size);
+    if (*first < 0) *first = 0;
+    if (*last > canopy->grid_dims[axis] - 1) *last = canopy->grid_dims[axis] - 1;
+}
+
+// Bin segments in a uniform grid, padded by the stroke footprint.
+// Cells are stored as (first index, count) into a flat list of segment indices.
+static int build_grid(canopy_t* canopy, float thickness)
+{
+    int last_status = PG_SUCCESS;
+
+    // a pixel is lit up to 2 * thickness away from a segment
+    float pad = 2.0f * thickness;
+    float lo[2] = { INFINITY, INFINITY };
+    float hi[2] = { -INFINITY, -INFINITY };
+    for (int i = 0; i < canopy->segment_count; i++)
+    {
+        const float* segment = canopy->segments + 4 * i;
+        for (int axis = 0; axis < 2; axis++)
+        {
+            lo[axis] = fminf(lo[axis], fminf(segment[axis], segment[axis + 2]) - pad);
+            hi[axis] = fmaxf(hi[axis], fmaxf(segment[axis], segment[axis + 2]) + pad);
+        }
+    }
+
+    // about one cell per segment, but never smaller than the footprint
+    float area = (hi[0] - lo[0]) * (hi[1] - lo[1]);
+    float cell_size = sqrtf(area / (CANOPY_GRID_CELLS_PER_SEGMENT * canopy->segment_count));
+    if (cell_size < 2.0f * pad) cell_size = 2.0f * pad;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        int dim = (int)ceilf((hi[axis] - lo[axis]) / cell_size);
+        if (dim > CANOPY_GRID_MAX_DIM) cell_size = (hi[axis] - lo[axis]) / CANOPY_GRID_MAX_DIM;
+    }
+
+    canopy->grid_origin[0] = lo[0];
+    canopy->grid_origin[1] = lo[1];
+    canopy->grid_cell_size = cell_size;
+    canopy->grid_dims[0] = (int)ceilf((hi[0] - lo[0]) / cell_size);
+    canopy->grid_dims[1] = (int)ceilf((hi[1] - lo[1]) / cell_size);
+    if (canopy->grid_dims[0] < 1) canopy->grid_dims[0] = 1;
+    if (canopy->grid_dims[1] < 1) canopy->grid_dims[1] = 1;
+
+    int cell_count = canopy->grid_dims[0] * canopy->grid_dims[1];
+    GLint* cells = (GLint*)calloc((size_t)cell_count * 2, sizeof(GLint));
+    if (!cells) return PG_ALLOCATION_ERROR;
+
+    // count, prefix sum, then fill
+    size_t total = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        GLint* indices = NULL;
+        if (pass == 1)
+        {
+            indices = (GLint*)malloc((total ? total : 1) * sizeof(GLint));
+            if (!indices)
+            {
+                free(cells);
+                return PG_ALLOCATION_ERROR;
+            }
+
+            GLint first = 0;
+            for (int c = 0; c < cell_count; c++)
+            {
+                cells[2 * c] = first;
+                first += cells[2 * c + 1];
+                cells[2 * c + 1] = 0;
+            }
+        }
+
+        for (int i = 0; i < canopy->segment_count; i++)
+        {
+            const float* segment = canopy->segments + 4 * i;
+            int x0, x1, y0, y1;
+            cell_range(canopy, fminf(segment[0], segment[2]) - pad, fmaxf(segment[0], segment[2]) + pad, 0, &x0, &x1);
+            cell_range(canopy, fminf(segment[1], segment[3]) - pad, fmaxf(segment[1], segment[3]) + pad, 1, &y0, &y1);
+
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    GLint* cell = cells + 2 * (y * canopy->grid_dims[0] + x);
+                    if (pass == 1) indices[cell[0] + cell[1]] = i;
+                    else total++;
+                    cell[1]++;
+                }
+            }
+        }
+
+        if (pass == 1)
+        {
+            upload_buffer_texture(canopy->index_buffer, canopy->index_texture, GL_R32I, (GLsizeiptr)(total * sizeof(GLint)), indices);
+            free(indices);
+        }
+    }
+
+    upload_buffer_texture(canopy->cell_buffer, canopy->cell_texture, GL_RG32I, (GLsizeiptr)cell_count * 2 * sizeof(GLint), cells);
+    free(cells);
+
+    canopy->grid_thickness = thickness;
+    printf("[>] Canopy grid: %dx%d cells, %.1f segments per cell\n",
+        canopy->grid_dims[0], canopy->grid_dims[1], (double)total / cell_count);
+
+    return last_status;
+}
+
+// Regenerate and upload the branches only when a tree parameter changed,
+// the grid also depends on the thickness
+int update_canopy(canopy_t* canopy, const canopy_params_t* params)
+{
+    int last_status = PG_SUCCESS;
+
+    if (canopy->segments &&
+        canopy->params.branch_angle == params->branch_angle &&
+        canopy->params.branch_length == params->branch_length &&
+        canopy->params.decay == params->decay &&
+        canopy->params.depth == params->depth)
+    {
+        if (canopy->grid_thickness != params->thickness)
+        {
+            CHECK_CALL(build_grid, canopy, params->thickness);
+        }
+        return last_status;
+    }
+
+    float* segments = NULL;
+    int count = 0;
+    CHECK_CALL(generate_canopy_segments, params, &segments, &count);
+
+    free(canopy->segments);
+    canopy->segments = segments;
+    canopy->segment_count = count;
+    canopy->params = *params;
+
+    upload_buffer_texture(canopy->buffer, canopy->texture, GL_RGBA32F, (GLsizeiptr)count * 4 * sizeof(float), segments);
+    printf("[>] Canopy generated: depth %d, %d segments\n", params->depth, count);
+
+    CHECK_CALL(build_grid, canopy, params->thickness);
+
+    return last_status;
+}
+
+void set_canopy_uniforms(canopy_t* canopy, const canopy_params_t* params, GLuint program)
+{
+    glUniform1f(glGetUniformLocation(program, "thickness"), params->thickness);
+    glUniform3f(glGetUniformLocation(program, "color1"), 0.0, 0.0, 0.0);
+    glUniform3f(glGetUniformLocation(program, "color2"), 0.5, 1.0, 0.7);
+    glUniform1i(glGetUniformLocation(program, "branches"), 3);
+    glUniform1i(glGetUniformLocation(program, "grid_cells"), 4);
+    glUniform1i(glGetUniformLocation(program, "grid_indices"), 5);
+    glUniform2f(glGetUniformLocation(program, "grid_origin"), canopy->grid_origin[0], canopy->grid_origin[1]);
+    glUniform1f(glGetUniformLocation(program, "grid_cell_size"), canopy->grid_cell_size);
+    glUniform2i(glGetUniformLocation(program, "grid_dims"), canopy->grid_dims[0], canopy->grid_dims[1]);
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, canopy->texture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_BUFFER, canopy->cell_texture);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_BUFFER, canopy->index_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Draw every branch as an instanced quad covering its outline only
+void draw_canopy_segments(canopy_t* canopy, const canopy_params_t* params, int width, int height)
+{
+    const float identity[4] = { 1.0f, 1.0f, 0.0f, 0.0f };
+    draw_segments(&canopy->raster, canopy->raster_program, canopy->segment_count, params->thickness, identity, width, height);
+}
+
+// Rebuild the whole tree on the GPU every frame, one transform feedback pass per level.
+// A pass reads the parents from the animated buffer and emits their two children,
+// which are copied after the previous levels so the buffer keeps the CPU layout.
+int draw_animated_canopy(canopy_t* canopy, const canopy_params_t* params, float time, int width, int height)
+{
+    int last_status = PG_SUCCESS;
+    GLsizeiptr segment_size = 4 * sizeof(float);
+    int count = (1 << (params->depth + 1)) - 2;
+
+    if (canopy->animated_depth != params->depth)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, canopy->animated_buffer);
+        glBufferData(GL_ARRAY_BUFFER, count * segment_size, NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_ARRAY_BUFFER, canopy->feedback_buffer);
+        glBufferData(GL_ARRAY_BUFFER, count * segment_size, NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        canopy->animated_depth = params->depth;
+    }
+
+    GLuint program = canopy->feedback_program;
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "depth"), params->depth);
+    glUniform1f(glGetUniformLocation(program, "time"), time);
+    glUniform1f(glGetUniformLocation(program, "branch_angle"), params->branch_angle);
+    glUniform1f(glGetUniformLocation(program, "branch_length"), params->branch_length);
+    glUniform1f(glGetUniformLocation(program, "decay"), params->decay);
+    glUniform1f(glGetUniformLocation(program, "sway"), CANOPY_SWAY);
+    glUniform2f(glGetUniformLocation(program, "trunk"), CANOPY_TRUNK_X, CANOPY_TRUNK_Y);
+    GLint level_loc = glGetUniformLocation(program, "level");
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(canopy->feedback_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, canopy->animated_buffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glBindBuffer(GL_COPY_READ_BUFFER, canopy->feedback_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, canopy->animated_buffer);
+
+    // the trunk pass has a single virtual parent, it only reads uniforms
+    int parent_start = 0;
+    int parent_count = 1;
+    int child_start = 0;
+    for (int level = 0; level < params->depth; level++)
+    {
+        GLsizeiptr offset = child_start * segment_size;
+        GLsizeiptr size = 2 * parent_count * segment_size;
+
+        glUniform1i(level_loc, level);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, (GLsizei)segment_size, (void*)(parent_start * segment_size));
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, canopy->feedback_buffer, offset, size);
+
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArraysInstanced(GL_POINTS, 0, 2, parent_count);
+        glEndTransformFeedback();
+
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, offset, size);
+
+        parent_start = child_start;
+        child_start += 2 * parent_count;
+        parent_count = level == 0 ? 2 : 2 * parent_count;
+    }
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    const float identity[4] = { 1.0f, 1.0f, 0.0f, 0.0f };
+    draw_segments(&canopy->animated, canopy->raster_program, count, params->thickness, identity, width, height);
+
+    return last_status;
+}
+
+void free_canopy(canopy_t* canopy)
+{
+    free(canopy->segments);
+    canopy->segments = NULL;
+    if (canopy->buffer) glDeleteBuffers(1, &canopy->buffer);
+    if (canopy->texture) glDeleteTextures(1, &canopy->texture);
+    if (canopy->cell_buffer) glDeleteBuffers(1, &canopy->cell_buffer);
+    if (canopy->cell_texture) glDeleteTextures(1, &canopy->cell_texture);
+    if (canopy->index_buffer) glDeleteBuffers(1, &canopy->index_buffer);
+    if (canopy->index_texture) glDeleteTextures(1, &canopy->index_texture);
+    free_segment_renderer(&canopy->raster);
+    free_segment_renderer(&canopy->animated);
+    if (canopy->feedback_vao) glDeleteVertexArrays(1, &canopy->feedback_vao);
+    if (canopy->animated_buffer) glDeleteBuffers(1, &canopy->animated_buffer);
+    if (canopy->feedback_buffer) glDeleteBuffers(1, &canopy->feedback_buffer);
+    if (canopy->feedback_program) glDeleteProgram(canopy->feedback_program);
+    if (canopy->raster_program) glDeleteProgram(canopy->raster_program);
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/checkerboard.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+
+int init_checkerboard(checkerboard_t* checkerboard)
+{
+    int last_status = PG_SUCCESS;
+
+    checkerboard->parity = 0;
+    checkerboard->current = 0;
+    checkerboard->history_valid = 0;
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_checkerboard.glsl", &checkerboard->resolve_program);
+
+    return last_status;
+}
+
+// Bind the half width target the generator shades this frame
+int begin_checkerboard(checkerboard_t* checkerboard, int width, int height)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(resize_render_target, &checkerboard->half, (width + 1) / 2, height, GL_RGBA8);
+    bind_render_target(&checkerboard->half);
+    checkerboard->parity ^= 1;
+
+    return last_status;
+}
+
+// Previous frame uv of the pixel at uv, from the view change since the last frame.
+// Views follow the generator mapping: world = ((4 uv - 2) * (aspect, 1)) / zoom + offset
+static void reprojection(checkerboard_t* checkerboard, state_t* state, float aspect, float scale[2], float offset[2])
+{
+    float ratio = checkerboard->zoom / state->zoom;
+    float delta_x = state->offset[0] - checkerboard->offset[0];
+    float delta_y = state->offset[1] - checkerboard->offset[1];
+
+    scale[0] = ratio;
+    scale[1] = ratio;
+    offset[0] = 0.5f * (1.0f - ratio) + delta_x * checkerboard->zoom / (4.0f * aspect);
+    offset[1] = 0.5f * (1.0f - ratio) + delta_y * checkerboard->zoom / 4.0f;
+}
+
+// Rebuild the full frame from the shaded half and the reprojected history.
+// The resolved texture becomes the history of the next frame.
+int resolve_checkerboard(checkerboard_t* checkerboard, state_t* state, int width, int height, GLuint vao, int view_dependent, GLuint* texture)
+{
+    int last_status = PG_SUCCESS;
+
+    int previous = checkerboard->current;
+    int current = 1 - previous;
+
+    if (checkerboard->history[previous].width != width || checkerboard->history[previous].height != height)
+    {
+        checkerboard->history_valid = 0;
+    }
+    CHECK_CALL(resize_render_target, &checkerboard->history[current], width, height, GL_RGBA8);
+
+    float scale[2] = { 1.0f, 1.0f };
+    float offset[2] = { 0.0f, 0.0f };
+    if (view_dependent && checkerboard->history_valid)
+    {
+        reprojection(checkerboard, state, (float)width / (float)height, scale, offset);
+    }
+
+    bind_render_target(&checkerboard->history[current]);
+
+    GLuint program = checkerboard->resolve_program;
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "half_texture"), 0);
+    glUniform1i(glGetUniformLocation(program, "history_texture"), 1);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)width, (float)height);
+    glUniform1i(glGetUniformLocation(program, "parity"), checkerboard->parity);
+    glUniform1i(glGetUniformLocation(program, "history_valid"), checkerboard->history_valid);
+    glUniform2f(glGetUniformLocation(program, "reproject_scale"), scale[0], scale[1]);
+    glUniform2f(glGetUniformLocation(program, "reproject_offset"), offset[0], offset[1]);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, checkerboard->half.texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, checkerboard->history[previous].texture);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glActiveTexture(GL_TEXTURE0);
+
+    checkerboard->zoom = state->zoom;
+    checkerboard->offset[0] = state->offset[0];
+    checkerboard->offset[1] = state->offset[1];
+    checkerboard->current = current;
+    checkerboard->history_valid = 1;
+
+    *texture = checkerboard->history[current].texture;
+
+    return last_status;
+}
+
+// History is only kept while the view moves, full frames are shaded when idle
+void reset_checkerboard(checkerboard_t* checkerboard)
+{
+    checkerboard->history_valid = 0;
+}
+
+void free_checkerboard(checkerboard_t* checkerboard)
+{
+    if (checkerboard->resolve_program) glDeleteProgram(checkerboard->resolve_program);
+    delete_render_target(&checkerboard->half);
+    delete_render_target(&checkerboard->history[0]);
+    delete_render_target(&checkerboard->history[1]);
+}
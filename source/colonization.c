@@ -0,0 +1,394 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/colonization.h"
+
+// Growth state. Every point keeps its nearest node, only the nodes created since
+// the last search can be closer: they are the only ones in the grid, which is emptied
+// after each search. A cell is as wide as the influence radius so a point only looks at its 3x3 cells.
+typedef struct growth_s
+{
+    float* points;
+    int point_count;
+    int* nearest;
+    float* distance;
+
+    float* nodes;
+    int* parents;
+    int node_count;
+    float* pull;
+    int* pull_count;
+    float* grown;               // direction of the last child of every node
+    int* pulled;                // nodes with a pull this step
+    int pulled_count;
+
+    int cells;
+    int* cell_head;
+    int* node_next;
+    int fresh;                  // first node not searched yet
+} growth_t;
+
+typedef struct worker_s
+{
+    growth_t* growth;
+    int first;
+    int last;
+} worker_t;
+
+static int cell_coordinate(float x, int cells)
+{
+    int c = (int)((x + COLONIZATION_EXTENT) / COLONIZATION_INFLUENCE);
+    if (c < 0) return 0;
+    if (c > cells - 1) return cells - 1;
+    return c;
+}
+
+static int node_cell(const growth_t* growth, int n)
+{
+    return cell_coordinate(growth->nodes[2 * n + 1], growth->cells) * growth->cells + 
+        cell_coordinate(growth->nodes[2 * n], growth->cells);
+}
+
+static void add_node(growth_t* growth, float x, float y, int parent)
+{
+    int i = growth->node_count++;
+    growth->nodes[2 * i] = x;
+    growth->nodes[2 * i + 1] = y;
+    growth->parents[i] = parent;
+    growth->pull[2 * i] = 0.0f;
+    growth->pull[2 * i + 1] = 0.0f;
+    growth->pull_count[i] = 0;
+    growth->grown[2 * i] = 0.0f;
+    growth->grown[2 * i + 1] = 0.0f;
+
+    int cell = node_cell(growth, i);
+    growth->node_next[i] = growth->cell_head[cell];
+    growth->cell_head[cell] = i;
+}
+
+// Update the nearest node of every point in the range with the new nodes, the grid is read only here
+static void* find_nearest_nodes(void* arg)
+{
+    worker_t* worker = (worker_t*)arg;
+    growth_t* growth = worker->growth;
+
+    for (int p = worker->first; p < worker->last; p++)
+    {
+        float x = growth->points[2 * p];
+        float y = growth->points[2 * p + 1];
+        int cx = cell_coordinate(x, growth->cells);
+        int cy = cell_coordinate(y, growth->cells);
+        float best = growth->distance[p];
+        int nearest = growth->nearest[p];
+
+        for (int j = cy - 1; j <= cy + 1; j++)
+        {
+            for (int i = cx - 1; i <= cx + 1; i++)
+            {
+                if (i < 0 || j < 0 || i >= growth->cells || j >= growth->cells) continue;
+                for (int n = growth->cell_head[j * growth->cells + i]; n >= 0; n = growth->node_next[n])
+                {
+                    float dx = growth->nodes[2 * n] - x;
+                    float dy = growth->nodes[2 * n + 1] - y;
+                    float d = dx * dx + dy * dy;
+                    if (d < best)
+                    {
+                        best = d;
+                        nearest = n;
+                    }
+                }
+            }
+        }
+
+        growth->nearest[p] = nearest;
+        growth->distance[p] = best;
+    }
+
+    return NULL;
+}
+
+static int find_all_nearest_nodes(growth_t* growth)
+{
+    pthread_t threads[COLONIZATION_THREADS];
+    worker_t workers[COLONIZATION_THREADS];
+    int chunk = (growth->point_count + COLONIZATION_THREADS - 1) / COLONIZATION_THREADS;
+    int started = 0;
+    int last_status = PG_SUCCESS;
+
+    for (int t = 0; t < COLONIZATION_THREADS; t++)
+    {
+        workers[t].growth = growth;
+        workers[t].first = t * chunk < growth->point_count ? t * chunk : growth->point_count;
+        workers[t].last = (t + 1) * chunk < growth->point_count ? (t + 1) * chunk : growth->point_count;
+        if (pthread_create(&threads[t], NULL, find_nearest_nodes, &workers[t]))
+        {
+            last_status = PG_EXTERNAL_ERROR;
+            break;
+        }
+        started++;
+    }
+
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+
+    for (int n = growth->fresh; n < growth->node_count; n++) growth->cell_head[node_cell(growth, n)] = -1;
+    growth->fresh = growth->node_count;
+    return last_status;
+}
+
+// Attraction points fill an ellipse above the trunk
+static void scatter_points(growth_t* growth, uint32_t* seed)
+{
+    int count = 0;
+    while (count < COLONIZATION_POINTS)
+    {
+        float x = random_range(seed, -1.0f, 1.0f);
+        float y = random_range(seed, -1.0f, 1.0f);
+        if (x * x + y * y > 1.0f) continue;
+
+        growth->points[2 * count] = x * COLONIZATION_CROWN_RX;
+        growth->points[2 * count + 1] = COLONIZATION_CROWN_Y + y * COLONIZATION_CROWN_RY;
+        growth->nearest[count] = -1;
+        growth->distance[count] = COLONIZATION_INFLUENCE * COLONIZATION_INFLUENCE;
+        count++;
+    }
+    growth->point_count = count;
+}
+
+// The trunk grows straight up until it reaches the influence of a point
+static void grow_trunk(growth_t* growth)
+{
+    add_node(growth, CANOPY_TRUNK_X, CANOPY_TRUNK_Y, -1);
+
+    float lowest = INFINITY;
+    for (int p = 0; p < growth->point_count; p++) lowest = fminf(lowest, growth->points[2 * p + 1]);
+
+    while (growth->node_count < COLONIZATION_MAX_NODES)
+    {
+        int tip = growth->node_count - 1;
+        float y = growth->nodes[2 * tip + 1];
+        if (y + COLONIZATION_INFLUENCE > lowest) break;
+        add_node(growth, growth->nodes[2 * tip], y + COLONIZATION_STEP, tip);
+    }
+}
+
+// One growth step: every node pulled by points grows a child a step towards their mean direction
+static int grow(growth_t* growth, int* p_grown)
+{
+    int last_status = PG_SUCCESS;
+    CHECK_CALL(find_all_nearest_nodes, growth);
+
+    // accumulate the pulls and drop the points reached by a node
+    int alive = 0;
+    for (int p = 0; p < growth->point_count; p++)
+    {
+        int n = growth->nearest[p];
+        if (n >= 0)
+        {
+            float dx = growth->points[2 * p] - growth->nodes[2 * n];
+            float dy = growth->points[2 * p + 1] - growth->nodes[2 * n + 1];
+            float d = sqrtf(dx * dx + dy * dy);
+            if (d > 0.0f)
+            {
+                growth->pull[2 * n] += dx / d;
+                growth->pull[2 * n + 1] += dy / d;
+            }
+            if (!growth->pull_count[n]++) growth->pulled[growth->pulled_count++] = n;
+        }
+
+        if (growth->distance[p] >= COLONIZATION_KILL * COLONIZATION_KILL)
+        {
+            growth->points[2 * alive] = growth->points[2 * p];
+            growth->points[2 * alive + 1] = growth->points[2 * p + 1];
+            growth->nearest[alive] = growth->nearest[p];
+            growth->distance[alive] = growth->distance[p];
+            alive++;
+        }
+    }
+    growth->point_count = alive;
+
+    // nodes with a pull grow a child, their accumulators are cleared for the next step.
+    // A node whose child did not get any closer is pulled the same way again, it is not regrown.
+    int grown = 0;
+    for (int k = 0; k < growth->pulled_count; k++)
+    {
+        int n = growth->pulled[k];
+        float dx = growth->pull[2 * n];
+        float dy = growth->pull[2 * n + 1];
+        float d = sqrtf(dx * dx + dy * dy);
+        growth->pull[2 * n] = 0.0f;
+        growth->pull[2 * n + 1] = 0.0f;
+        growth->pull_count[n] = 0;
+        if (d < 1e-6f || growth->node_count == COLONIZATION_MAX_NODES) continue;
+
+        dx /= d;
+        dy /= d;
+        if (dx * growth->grown[2 * n] + dy * growth->grown[2 * n + 1] > COLONIZATION_SAME_DIRECTION) continue;
+        growth->grown[2 * n] = dx;
+        growth->grown[2 * n + 1] = dy;
+
+        add_node(growth, growth->nodes[2 * n] + dx * COLONIZATION_STEP,
+            growth->nodes[2 * n + 1] + dy * COLONIZATION_STEP, n);
+        grown++;
+    }
+    growth->pulled_count = 0;
+
+    *p_grown = grown;
+    return last_status;
+}
+
+static void free_growth(growth_t* growth)
+{
+    free(growth->points);
+    free(growth->nearest);
+    free(growth->distance);
+    free(growth->nodes);
+    free(growth->parents);
+    free(growth->pull);
+    free(growth->pull_count);
+    free(growth->grown);
+    free(growth->pulled);
+    free(growth->cell_head);
+    free(growth->node_next);
+}
+
+static int alloc_growth(growth_t* growth, int point_capacity, int node_capacity)
+{
+    growth->cells = (int)ceilf(2.0f * COLONIZATION_EXTENT / COLONIZATION_INFLUENCE);
+    growth->points = (float*)malloc((size_t)point_capacity * 2 * sizeof(float));
+    growth->nearest = (int*)malloc((size_t)point_capacity * sizeof(int));
+    growth->distance = (float*)malloc((size_t)point_capacity * sizeof(float));
+    growth->nodes = (float*)malloc((size_t)node_capacity * 2 * sizeof(float));
+    growth->parents = (int*)malloc((size_t)node_capacity * sizeof(int));
+    growth->pull = (float*)malloc((size_t)node_capacity * 2 * sizeof(float));
+    growth->pull_count = (int*)malloc((size_t)node_capacity * sizeof(int));
+    growth->grown = (float*)malloc((size_t)node_capacity * 2 * sizeof(float));
+    growth->pulled = (int*)malloc((size_t)node_capacity * sizeof(int));
+    growth->node_next = (int*)malloc((size_t)node_capacity * sizeof(int));
+    growth->cell_head = (int*)malloc((size_t)growth->cells * growth->cells * sizeof(int));
+    if (!growth->points || !growth->nearest || !growth->distance || !growth->nodes || !growth->parents ||
+        !growth->pull || !growth->pull_count || !growth->grown || !growth->pulled || !growth->node_next || !growth->cell_head)
+    {
+        return PG_ALLOCATION_ERROR;
+    }
+    memset(growth->cell_head, 0xff, (size_t)growth->cells * growth->cells * sizeof(int));
+    growth->point_count = 0;
+    growth->node_count = 0;
+    growth->pulled_count = 0;
+    growth->fresh = 0;
+
+    return PG_SUCCESS;
+}
+
+static int colonize(growth_t* growth)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(alloc_growth, growth, COLONIZATION_POINTS, COLONIZATION_MAX_NODES);
+
+    uint32_t seed = COLONIZATION_SEED;
+    scatter_points(growth, &seed);
+    grow_trunk(growth);
+
+    int iteration = 0;
+    int grown = 1;
+    while (grown && growth->point_count && iteration < COLONIZATION_MAX_ITERATIONS)
+    {
+        CHECK_CALL(grow, growth, &grown);
+        iteration++;
+    }
+
+    printf("[>] Space colonization: %d nodes in %d iterations, %d points left\n",
+        growth->node_count, iteration, growth->point_count);
+
+    return last_status;
+}
+
+// Nearest node of every point within the influence radius, -1 when there is none.
+// Nodes are added batch after batch and searched like during the growth.
+int search_nearest_nodes(const float* points, int point_count, const float* nodes, int node_count, int batch, int* nearest)
+{
+    int last_status = PG_SUCCESS;
+
+    if (point_count < 1 || node_count < 1 || batch < 1) return PG_INVALID_PARAMETER;
+
+    growth_t growth = { 0 };
+    CHECK_CALL_GOTO_ERROR(alloc_growth, cleanup, &growth, point_count, node_count);
+
+    memcpy(growth.points, points, (size_t)point_count * 2 * sizeof(float));
+    growth.point_count = point_count;
+    for (int p = 0; p < point_count; p++)
+    {
+        growth.nearest[p] = -1;
+        growth.distance[p] = COLONIZATION_INFLUENCE * COLONIZATION_INFLUENCE;
+    }
+
+    for (int first = 0; first < node_count; first += batch)
+    {
+        int last = first + batch < node_count ? first + batch : node_count;
+        for (int n = first; n < last; n++) add_node(&growth, nodes[2 * n], nodes[2 * n + 1], -1);
+        CHECK_CALL_GOTO_ERROR(find_all_nearest_nodes, cleanup, &growth);
+    }
+
+    memcpy(nearest, growth.nearest, (size_t)point_count * sizeof(int));
+
+cleanup:
+    free_growth(&growth);
+    return last_status;
+}
+
+int init_colonization(colonization_t* colonization)
+{
+    int last_status = PG_SUCCESS;
+
+    growth_t growth = { 0 };
+    last_status = colonize(&growth);
+    if (last_status)
+    {
+        free_growth(&growth);
+        return last_status;
+    }
+
+    // one segment from every node but the root to its parent
+    colonization->segment_count = growth.node_count - 1;
+    float* segments = (float*)malloc((size_t)(colonization->segment_count > 0 ? colonization->segment_count : 1) * 4 * sizeof(float));
+    if (!segments)
+    {
+        free_growth(&growth);
+        return PG_ALLOCATION_ERROR;
+    }
+
+    for (int n = 1; n < growth.node_count; n++)
+    {
+        float* segment = segments + 4 * (n - 1);
+        int parent = growth.parents[n];
+        segment[0] = growth.nodes[2 * parent];
+        segment[1] = growth.nodes[2 * parent + 1];
+        segment[2] = growth.nodes[2 * n];
+        segment[3] = growth.nodes[2 * n + 1];
+    }
+    free_growth(&growth);
+
+    glGenBuffers(1, &colonization->buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, colonization->buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(colonization->segment_count > 0 ? colonization->segment_count : 1) * 4 * sizeof(float),
+        segments, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    free(segments);
+
+    CHECK_CALL(init_segment_renderer, &colonization->renderer, colonization->buffer);
+
+    return last_status;
+}
+
+void draw_colonization(colonization_t* colonization, GLuint program, int width, int height)
+{
+    const float identity[4] = { 1.0f, 1.0f, 0.0f, 0.0f };
+    draw_segments(&colonization->renderer, program, colonization->segment_count, COLONIZATION_THICKNESS, identity, width, height);
+}
+
+void free_colonization(colonization_t* colonization)
+{
+    free_segment_renderer(&colonization->renderer);
+    if (colonization->buffer) glDeleteBuffers(1, &colonization->buffer);
+}
@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/color_lut.h"
+#include "../include/shaders.h"
+
+// Grid points of the LUT for these parameters, 0 when it cannot hold them.
+// The steps of the linear quantization sit halfway between the levels. With an odd number
+// of grid intervals per level they fall halfway between two grid points, and the nearest
+// grid point of every color quantizes like the color. The other methods are close to it.
+static int color_lut_size(int method, int levels, int max_size)
+{
+    if (method < 0) return max_size;
+
+    int intervals = (max_size - 1) / (levels - 1);
+    if (intervals < 1) return 0;
+    if (intervals % 2 == 0) intervals--;
+
+    return (levels - 1) * intervals + 1;
+}
+
+// The texture gets its storage from the first bake, sized for the quantization
+int init_color_lut(color_lut_t* lut, int max_size)
+{
+    int last_status = PG_SUCCESS;
+
+    lut->max_size = max_size;
+    lut->size = 0;
+    lut->levels = 0;
+    CHECK_CALL(create_program, "shaders/vertex_fullscreen.glsl", "shaders/fragment_color_lut.glsl", &lut->program);
+
+    glGenTextures(1, &lut->texture);
+    glBindTexture(GL_TEXTURE_3D, lut->texture);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    glGenFramebuffers(1, &lut->fbo);
+    glGenVertexArrays(1, &lut->vao);
+
+    return last_status;
+}
+
+// Bake the quantization for these parameters, unless the texture already holds it.
+// Slices are rendered one at a time, the framebuffer, viewport and program in use are restored.
+// Too many levels for the largest LUT leave it empty, the quantization then runs per fragment.
+int update_color_lut(color_lut_t* lut, int method, int levels)
+{
+    int last_status = PG_SUCCESS;
+
+    if (lut->levels == levels && lut->method == method) return last_status;
+
+    int size = color_lut_size(method, levels, lut->max_size);
+    if (!size)
+    {
+        lut->size = 0;
+        lut->method = method;
+        lut->levels = levels;
+        printf("[>] %d levels do not fit in a %d^3 color LUT, quantized per fragment\n", levels, lut->max_size);
+        return last_status;
+    }
+
+    if (size != lut->size)
+    {
+        glBindTexture(GL_TEXTURE_3D, lut->texture);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA8, size, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glBindTexture(GL_TEXTURE_3D, 0);
+        lut->size = size;
+    }
+
+    GLint framebuffer = 0;
+    GLint program = 0;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, lut->fbo);
+    glViewport(0, 0, lut->size, lut->size);
+    glUseProgram(lut->program);
+    glUniform1i(glGetUniformLocation(lut->program, "lut_size"), lut->size);
+    glUniform1i(glGetUniformLocation(lut->program, "quantization_method"), method);
+    glUniform1i(glGetUniformLocation(lut->program, "quantization_levels"), levels);
+    GLint slice_loc = glGetUniformLocation(lut->program, "slice");
+
+    glBindVertexArray(lut->vao);
+    for (int slice = 0; slice < lut->size; slice++)
+    {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, lut->texture, 0, slice);
+        if (slice == 0 && glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            fprintf(stderr, "Color LUT framebuffer is not complete\n");
+            last_status = PG_INITIALIZATION_ERROR;
+            break;
+        }
+        glUniform1i(slice_loc, slice);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    // quantization is a staircase, blending neighbor grid points would soften every step
+    GLint filter = method >= 0 ? GL_NEAREST : GL_LINEAR;
+    glBindTexture(GL_TEXTURE_3D, lut->texture);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, filter);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glUseProgram((GLuint)program);
+
+    if (last_status) return last_status;
+
+    lut->method = method;
+    lut->levels = levels;
+    printf("[>] Color LUT %d^3 baked, quantization method %d, %d levels\n", lut->size, method, levels);
+
+    return last_status;
+}
+
+// The program samples color_lut, its texel centers sitting on the baked grid points,
+// or quantizes itself with the same parameters when lut_size is 0
+void bind_color_lut(const color_lut_t* lut, GLuint program)
+{
+    glUniform1i(glGetUniformLocation(program, "color_lut"), COLOR_LUT_UNIT);
+    glUniform1f(glGetUniformLocation(program, "lut_size"), (float)lut->size);
+    glUniform1i(glGetUniformLocation(program, "quantization_method"), lut->method);
+    glUniform1i(glGetUniformLocation(program, "quantization_levels"), lut->levels);
+    glActiveTexture(GL_TEXTURE0 + COLOR_LUT_UNIT);
+    glBindTexture(GL_TEXTURE_3D, lut->texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void free_color_lut(color_lut_t* lut)
+{
+    if (lut->program) glDeleteProgram(lut->program);
+    if (lut->texture) glDeleteTextures(1, &lut->texture);
+    if (lut->fbo) glDeleteFramebuffers(1, &lut->fbo);
+    if (lut->vao) glDeleteVertexArrays(1, &lut->vao);
+}
@@ -0,0 +1,221 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/edge_detection.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+
+#if defined(EDGE_DETECTION_AVX2)
+#include <immintrin.h>
+#endif
+
+#define EDGE_MAX_CHANNELS 3
+
+// The compute variant needs a GL 4.3 context, the fragment one stays the fallback
+int init_edge_detection(edge_detection_t* edges)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(create_program, "shaders/vertex_fullscreen.glsl", "shaders/fragment_edge.glsl", &edges->program);
+    if (GLEW_VERSION_4_3)
+    {
+        CHECK_CALL(create_compute_program, "shaders/compute_edge.comp", &edges->compute_program);
+    }
+    glGenVertexArrays(1, &edges->vao);
+
+    return last_status;
+}
+
+// Sobel magnitude of the texture into edges->target, at the size of the texture.
+// The framebuffer and viewport are left to the caller.
+int detect_edges(edge_detection_t* edges, GLuint texture, int width, int height, GLuint* output)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(resize_render_target, &edges->target, width, height, GL_R8);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    if (edges->compute_program)
+    {
+        // every tile reads its texels and their border once into shared memory
+        GLuint program = edges->compute_program;
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "source_texture"), 0);
+        glUniform2i(glGetUniformLocation(program, "size"), width, height);
+        glBindImageTexture(0, edges->target.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R8);
+        glDispatchCompute((width + EDGE_TILE_SIZE - 1) / EDGE_TILE_SIZE, (height + EDGE_TILE_SIZE - 1) / EDGE_TILE_SIZE, 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+    else
+    {
+        GLuint program = edges->program;
+        bind_render_target(&edges->target);
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "source_texture"), 0);
+        glUniform2f(glGetUniformLocation(program, "texel_size"), 1.0f / width, 1.0f / height);
+        glBindVertexArray(edges->vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    *output = edges->target.texture;
+
+    return last_status;
+}
+
+// Sobel magnitude of the pixel (x, y), the planes are padded by one
+// texel on each side. Same operations in the same order as the AVX2 twin.
+static float sobel_at(float* const* planes, int channels, int stride, int x, int y)
+{
+    float sum_x = 0.0f;
+    float sum_y = 0.0f;
+
+    for (int c = 0; c < channels; c++)
+    {
+        const float* top = planes[c] + (size_t)y * stride + x;
+        const float* middle = top + stride;
+        const float* bottom = middle + stride;
+
+        float dx = ((top[2] + 2.0f * middle[2]) + bottom[2]) - ((top[0] + 2.0f * middle[0]) + bottom[0]);
+        float dy = ((bottom[0] + 2.0f * bottom[1]) + bottom[2]) - ((top[0] + 2.0f * top[1]) + top[2]);
+        sum_x += dx * dx;
+        sum_y += dy * dy;
+    }
+
+    float edge = (sqrtf(sum_x) + sqrtf(sum_y)) * EDGE_SCALE;
+    return edge < 1.0f ? edge : 1.0f;
+}
+
+#if defined(EDGE_DETECTION_AVX2)
+// Eight pixels at once, returns the first column left to the scalar loop
+__attribute__((target("avx2")))
+static int sobel_row_avx2(float* const* planes, int channels, int stride, int y, int width, uint8_t* row)
+{
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(EDGE_SCALE);
+    const __m256 byte = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int32_t values[8];
+    int x = 0;
+
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256 sum_x = _mm256_setzero_ps();
+        __m256 sum_y = _mm256_setzero_ps();
+
+        for (int c = 0; c < channels; c++)
+        {
+            const float* top = planes[c] + (size_t)y * stride + x;
+            const float* middle = top + stride;
+            const float* bottom = middle + stride;
+
+            __m256 top_left = _mm256_loadu_ps(top);
+            __m256 top_center = _mm256_loadu_ps(top + 1);
+            __m256 top_right = _mm256_loadu_ps(top + 2);
+            __m256 left = _mm256_loadu_ps(middle);
+            __m256 right = _mm256_loadu_ps(middle + 2);
+            __m256 bottom_left = _mm256_loadu_ps(bottom);
+            __m256 bottom_center = _mm256_loadu_ps(bottom + 1);
+            __m256 bottom_right = _mm256_loadu_ps(bottom + 2);
+
+            __m256 dx = _mm256_sub_ps(
+                _mm256_add_ps(_mm256_add_ps(top_right, _mm256_mul_ps(two, right)), bottom_right),
+                _mm256_add_ps(_mm256_add_ps(top_left, _mm256_mul_ps(two, left)), bottom_left));
+            __m256 dy = _mm256_sub_ps(
+                _mm256_add_ps(_mm256_add_ps(bottom_left, _mm256_mul_ps(two, bottom_center)), bottom_right),
+                _mm256_add_ps(_mm256_add_ps(top_left, _mm256_mul_ps(two, top_center)), top_right));
+            sum_x = _mm256_add_ps(sum_x, _mm256_mul_ps(dx, dx));
+            sum_y = _mm256_add_ps(sum_y, _mm256_mul_ps(dy, dy));
+        }
+
+        __m256 edge = _mm256_mul_ps(_mm256_add_ps(_mm256_sqrt_ps(sum_x), _mm256_sqrt_ps(sum_y)), scale);
+        edge = _mm256_min_ps(edge, one);
+        _mm256_storeu_si256((__m256i*)values, _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(edge, byte), half)));
+        for (int i = 0; i < 8; i++) row[x + i] = (uint8_t)values[i];
+    }
+
+    return x;
+}
+#endif
+
+// CPU twin of edge_detection.glsl for pixels that never live on the GPU as a frame,
+// borders are clamped like the CLAMP_TO_EDGE targets of the render graph
+int detect_edges_cpu(const uint8_t* pixels, int width, int height, int channels, uint8_t* edges)
+{
+    int colors = channels < EDGE_MAX_CHANNELS ? channels : EDGE_MAX_CHANNELS;
+    int stride = width + 2;
+    size_t plane_size = (size_t)stride * (height + 2);
+
+    float* buffer = (float*)malloc(plane_size * colors * sizeof(float));
+    if (!buffer) return PG_ALLOCATION_ERROR;
+
+    float* planes[EDGE_MAX_CHANNELS];
+    for (int c = 0; c < colors; c++)
+    {
+        planes[c] = buffer + plane_size * c;
+        for (int y = -1; y <= height; y++)
+        {
+            int sy = y < 0 ? 0 : (y >= height ? height - 1 : y);
+            float* row = planes[c] + (size_t)(y + 1) * stride + 1;
+            const uint8_t* source = pixels + (size_t)sy * width * channels + c;
+            for (int x = 0; x < width; x++) row[x] = source[(size_t)x * channels] / 255.0f;
+            row[-1] = row[0];
+            row[width] = row[width - 1];
+        }
+    }
+
+#if defined(EDGE_DETECTION_AVX2)
+    int wide = __builtin_cpu_supports("avx2");
+#endif
+
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t* row = edges + (size_t)y * width;
+        int x = 0;
+#if defined(EDGE_DETECTION_AVX2)
+        if (wide) x = sobel_row_avx2(planes, colors, stride, y, width, row);
+#endif
+        for (; x < width; x++)
+        {
+            row[x] = (uint8_t)(sobel_at(planes, colors, stride, x, y) * 255.0f + 0.5f);
+        }
+    }
+
+    free(buffer);
+
+    return PG_SUCCESS;
+}
+
+// Edge map of an image loaded from disk, into edges->target
+int upload_edges(edge_detection_t* edges, const uint8_t* pixels, int width, int height, int channels)
+{
+    int last_status = PG_SUCCESS;
+
+    uint8_t* map = (uint8_t*)malloc((size_t)width * height);
+    if (!map) return PG_ALLOCATION_ERROR;
+
+    CHECK_CALL_GOTO_ERROR(detect_edges_cpu, cleanup, pixels, width, height, channels, map);
+    CHECK_CALL_GOTO_ERROR(resize_render_target, cleanup, &edges->target, width, height, GL_R8);
+
+    glBindTexture(GL_TEXTURE_2D, edges->target.texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, map);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    printf("[>] Edge map of %dx%d computed on the CPU\n", width, height);
+
+cleanup:
+    free(map);
+    return last_status;
+}
+
+void free_edge_detection(edge_detection_t* edges)
+{
+    if (edges->program) glDeleteProgram(edges->program);
+    if (edges->compute_program) glDeleteProgram(edges->compute_program);
+    if (edges->vao) glDeleteVertexArrays(1, &edges->vao);
+    delete_render_target(&edges->target);
+}
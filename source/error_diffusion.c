@@ -0,0 +1,287 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/error_diffusion.h"
+
+typedef struct diffusion_tap_s
+{
+    int dx;
+    int dy;
+    float weight;
+} diffusion_tap_t;
+
+typedef struct diffusion_kernel_s
+{
+    const char* name;
+    int tap_count;
+    diffusion_tap_t taps[12];
+} diffusion_kernel_t;
+
+// Every kernel spreads its error at most DIFFUSION_REACH pixels to the right, left and down
+static const diffusion_kernel_t kernels[] =
+{
+    [DIFFUSION_NONE] = { "none", 0, { { 0, 0, 0.0f } } },
+    [DIFFUSION_FLOYD_STEINBERG] = { "floyd-steinberg", 4,
+    {
+        { 1, 0, 7.0f / 16.0f },
+        { -1, 1, 3.0f / 16.0f }, { 0, 1, 5.0f / 16.0f }, { 1, 1, 1.0f / 16.0f },
+    } },
+    [DIFFUSION_JARVIS] = { "jarvis", 12,
+    {
+        { 1, 0, 7.0f / 48.0f }, { 2, 0, 5.0f / 48.0f },
+        { -2, 1, 3.0f / 48.0f }, { -1, 1, 5.0f / 48.0f }, { 0, 1, 7.0f / 48.0f }, { 1, 1, 5.0f / 48.0f }, { 2, 1, 3.0f / 48.0f },
+        { -2, 2, 1.0f / 48.0f }, { -1, 2, 3.0f / 48.0f }, { 0, 2, 5.0f / 48.0f }, { 1, 2, 3.0f / 48.0f }, { 2, 2, 1.0f / 48.0f },
+    } },
+    [DIFFUSION_STUCKI] = { "stucki", 12,
+    {
+        { 1, 0, 8.0f / 42.0f }, { 2, 0, 4.0f / 42.0f },
+        { -2, 1, 2.0f / 42.0f }, { -1, 1, 4.0f / 42.0f }, { 0, 1, 8.0f / 42.0f }, { 1, 1, 4.0f / 42.0f }, { 2, 1, 2.0f / 42.0f },
+        { -2, 2, 1.0f / 42.0f }, { -1, 2, 2.0f / 42.0f }, { 0, 2, 4.0f / 42.0f }, { 1, 2, 2.0f / 42.0f }, { 2, 2, 1.0f / 42.0f },
+    } },
+    // only 6/8 of the error is spread, extremes clip instead of smearing
+    [DIFFUSION_ATKINSON] = { "atkinson", 6,
+    {
+        { 1, 0, 1.0f / 8.0f }, { 2, 0, 1.0f / 8.0f },
+        { -1, 1, 1.0f / 8.0f }, { 0, 1, 1.0f / 8.0f }, { 1, 1, 1.0f / 8.0f },
+        { 0, 2, 1.0f / 8.0f },
+    } },
+};
+
+// Image being diffused, 4 floats per pixel whatever the channel count so a pixel
+// is one vector. Rows are padded by the reach on both sides and below the image,
+// writes past the edges land in the padding and are dropped.
+typedef struct diffusion_s
+{
+    const diffusion_kernel_t* kernel;
+    float* image;
+    int width;
+    int height;
+    int stride;                 // in pixels
+    float steps;                // levels - 1
+    int* progress;              // pixels of every row done, published every few pixels
+    int next_row;
+} diffusion_t;
+
+int parse_diffusion_kernel(const char* name, int* kernel)
+{
+    for (int k = DIFFUSION_NONE; k <= DIFFUSION_ATKINSON; k++)
+    {
+        if (!strcmp(name, kernels[k].name))
+        {
+            *kernel = k;
+            return PG_SUCCESS;
+        }
+    }
+
+    fprintf(stderr, "Unknown error diffusion kernel: %s\n", name);
+    return PG_INVALID_PARAMETER;
+}
+
+static void diffuse_pixel(const diffusion_t* diffusion, float* pixel)
+{
+    const diffusion_kernel_t* kernel = diffusion->kernel;
+    int row = 4 * diffusion->stride;
+
+#if defined(__SSE2__)
+    const __m128 steps = _mm_set1_ps(diffusion->steps);
+    const __m128 inverse_steps = _mm_set1_ps(1.0f / diffusion->steps);
+
+    // nearest level of every channel at once, the error carries what was lost
+    __m128 value = _mm_loadu_ps(pixel);
+    __m128 level = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(value, steps)));
+    level = _mm_min_ps(_mm_max_ps(level, _mm_setzero_ps()), steps);
+    __m128 quantized = _mm_mul_ps(level, inverse_steps);
+    __m128 error = _mm_sub_ps(value, quantized);
+    _mm_storeu_ps(pixel, quantized);
+
+    for (int t = 0; t < kernel->tap_count; t++)
+    {
+        const diffusion_tap_t* tap = &kernel->taps[t];
+        float* target = pixel + tap->dy * row + 4 * tap->dx;
+        __m128 spread = _mm_mul_ps(error, _mm_set1_ps(tap->weight));
+        _mm_storeu_ps(target, _mm_add_ps(_mm_loadu_ps(target), spread));
+    }
+#else
+    float error[4];
+    for (int c = 0; c < 4; c++)
+    {
+        float level = nearbyintf(pixel[c] * diffusion->steps);
+        if (level < 0.0f) level = 0.0f;
+        if (level > diffusion->steps) level = diffusion->steps;
+        float quantized = level / diffusion->steps;
+        error[c] = pixel[c] - quantized;
+        pixel[c] = quantized;
+    }
+
+    for (int t = 0; t < kernel->tap_count; t++)
+    {
+        const diffusion_tap_t* tap = &kernel->taps[t];
+        float* target = pixel + tap->dy * row + 4 * tap->dx;
+        for (int c = 0; c < 4; c++) target[c] += error[c] * tap->weight;
+    }
+#endif
+}
+
+// A row starts once the row above is far enough ahead that the errors it still
+// writes into this row never meet the ones this row writes, and stays behind it.
+// Rows above that one are further ahead still, each row waiting on its own.
+static void diffuse_row(diffusion_t* diffusion, int y)
+{
+    const int lag = 2 * DIFFUSION_REACH + 1;
+    int seen = y > 0 ? 0 : diffusion->width;
+    float* row = diffusion->image + 4 * ((size_t)y * diffusion->stride + DIFFUSION_REACH);
+
+    for (int x = 0; x < diffusion->width; x++)
+    {
+        int needed = x + lag < diffusion->width ? x + lag : diffusion->width;
+        while (seen < needed)
+        {
+            seen = __atomic_load_n(&diffusion->progress[y - 1], __ATOMIC_ACQUIRE);
+            if (seen < needed) sched_yield();
+        }
+
+        diffuse_pixel(diffusion, row + 4 * x);
+
+        if ((x + 1) % DIFFUSION_PUBLISH_STEP == 0)
+        {
+            __atomic_store_n(&diffusion->progress[y], x + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    __atomic_store_n(&diffusion->progress[y], diffusion->width, __ATOMIC_RELEASE);
+}
+
+// Rows are handed out in order, so the row a thread waits on is always being processed
+static void* diffuse_rows(void* arg)
+{
+    diffusion_t* diffusion = (diffusion_t*)arg;
+
+    for (;;)
+    {
+        int y = __atomic_fetch_add(&diffusion->next_row, 1, __ATOMIC_RELAXED);
+        if (y >= diffusion->height) break;
+        diffuse_row(diffusion, y);
+    }
+
+    return NULL;
+}
+
+// Gray and alpha or RGBA, the last channel is alpha and is never diffused
+static int count_color_channels(int channels)
+{
+    return channels == 2 || channels == 4 ? channels - 1 : channels;
+}
+
+// Spread the floats of the color channels over the padded rows, alpha stays zero
+static int load_diffusion(diffusion_t* diffusion, const uint8_t* pixels, int width, int height, int channels, int levels, int kernel)
+{
+    if (kernel <= DIFFUSION_NONE || kernel > DIFFUSION_ATKINSON) return PG_INVALID_PARAMETER;
+    if (width < 1 || height < 1 || channels < 1 || channels > 4 || levels < 2) return PG_INVALID_PARAMETER;
+
+    int color_channels = count_color_channels(channels);
+    diffusion->kernel = &kernels[kernel];
+    diffusion->width = width;
+    diffusion->height = height;
+    diffusion->stride = width + 2 * DIFFUSION_REACH;
+    diffusion->steps = (float)(levels - 1);
+
+    size_t floats = 4 * (size_t)diffusion->stride * (height + DIFFUSION_REACH);
+    diffusion->image = (float*)calloc(floats, sizeof(float));
+    diffusion->progress = (int*)calloc((size_t)height, sizeof(int));
+    if (!diffusion->image || !diffusion->progress) return PG_ALLOCATION_ERROR;
+
+    for (int y = 0; y < height; y++)
+    {
+        float* row = diffusion->image + 4 * ((size_t)y * diffusion->stride + DIFFUSION_REACH);
+        const uint8_t* source = pixels + (size_t)y * width * channels;
+        for (int x = 0; x < width; x++)
+        {
+            for (int c = 0; c < color_channels; c++)
+            {
+                row[4 * x + c] = source[x * channels + c] / 255.0f;
+            }
+        }
+    }
+
+    return PG_SUCCESS;
+}
+
+static void store_diffusion(const diffusion_t* diffusion, uint8_t* pixels, int channels)
+{
+    int color_channels = count_color_channels(channels);
+
+    for (int y = 0; y < diffusion->height; y++)
+    {
+        const float* row = diffusion->image + 4 * ((size_t)y * diffusion->stride + DIFFUSION_REACH);
+        uint8_t* destination = pixels + (size_t)y * diffusion->width * channels;
+        for (int x = 0; x < diffusion->width; x++)
+        {
+            for (int c = 0; c < color_channels; c++)
+            {
+                destination[x * channels + c] = (uint8_t)(row[4 * x + c] * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+static void free_diffusion(diffusion_t* diffusion)
+{
+    free(diffusion->image);
+    free(diffusion->progress);
+}
+
+// Quantize the color channels of an 8 bit image to the given number of levels in place,
+// the error of every pixel is spread over its unvisited neighbors by the kernel.
+// Rows run on several threads as a diagonal wavefront. Alpha is left untouched.
+int diffuse_error(uint8_t* pixels, int width, int height, int channels, int levels, int kernel)
+{
+    int last_status = PG_SUCCESS;
+
+    diffusion_t diffusion = { 0 };
+    CHECK_CALL_GOTO_ERROR(load_diffusion, cleanup, &diffusion, pixels, width, height, channels, levels, kernel);
+
+    pthread_t threads[DIFFUSION_THREADS];
+    int thread_count = height < DIFFUSION_THREADS ? height : DIFFUSION_THREADS;
+    int started = 0;
+    for (int t = 0; t < thread_count; t++)
+    {
+        if (pthread_create(&threads[t], NULL, diffuse_rows, &diffusion)) break;
+        started++;
+    }
+
+    // any number of threads gets through, none at all included
+    if (!started) diffuse_rows(&diffusion);
+    for (int t = 0; t < started; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    store_diffusion(&diffusion, pixels, channels);
+    printf("[>] Error diffusion: %s kernel, %d levels, %d threads\n", diffusion.kernel->name, levels, started ? started : 1);
+
+cleanup:
+    free_diffusion(&diffusion);
+    return last_status;
+}
+
+// Same result as diffuse_error, pixel after pixel in scan order on the calling thread
+int diffuse_error_serial(uint8_t* pixels, int width, int height, int channels, int levels, int kernel)
+{
+    int last_status = PG_SUCCESS;
+
+    diffusion_t diffusion = { 0 };
+    CHECK_CALL_GOTO_ERROR(load_diffusion, cleanup, &diffusion, pixels, width, height, channels, levels, kernel);
+
+    for (int y = 0; y < height; y++)
+    {
+        float* row = diffusion.image + 4 * ((size_t)y * diffusion.stride + DIFFUSION_REACH);
+        for (int x = 0; x < width; x++) diffuse_pixel(&diffusion, row + 4 * x);
+    }
+
+    store_diffusion(&diffusion, pixels, channels);
+
+cleanup:
+    free_diffusion(&diffusion);
+    return last_status;
+}
@@ -0,0 +1,287 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/forest.h"
+
+static void upload_rgba_buffer(GLuint buffer, GLuint texture, GLsizeiptr size, const void* content, GLenum usage)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, content, usage);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Canopy trees with varied decay and branch angle, rooted at the origin
+static int generate_templates(forest_t* forest, uint32_t* seed)
+{
+    int last_status = PG_SUCCESS;
+
+    float* segments[FOREST_TEMPLATES] = { NULL };
+    int total = 0;
+    for (int t = 0; t < FOREST_TEMPLATES; t++)
+    {
+        canopy_params_t params;
+        init_canopy_params(&params);
+        params.depth = FOREST_DEPTH;
+        params.decay = random_range(seed, 0.45f, 0.65f);
+        params.branch_angle = random_range(seed, (float)M_PI / 8.0f, (float)M_PI * 5.0f / 24.0f);
+
+        last_status = generate_canopy_segments(&params, &segments[t], &forest->template_count[t]);
+        if (last_status) break;
+
+        float* bounds = forest->template_bounds[t];
+        bounds[0] = bounds[1] = INFINITY;
+        bounds[2] = bounds[3] = -INFINITY;
+        for (int i = 0; i < 4 * forest->template_count[t]; i += 2)
+        {
+            segments[t][i] -= CANOPY_TRUNK_X;
+            segments[t][i + 1] -= CANOPY_TRUNK_Y;
+            bounds[0] = fminf(bounds[0], segments[t][i]);
+            bounds[1] = fminf(bounds[1], segments[t][i + 1]);
+            bounds[2] = fmaxf(bounds[2], segments[t][i]);
+            bounds[3] = fmaxf(bounds[3], segments[t][i + 1]);
+        }
+
+        forest->template_start[t] = total;
+        total += forest->template_count[t];
+    }
+
+    float* all = last_status ? NULL : (float*)malloc((size_t)total * 4 * sizeof(float));
+    if (all)
+    {
+        for (int t = 0; t < FOREST_TEMPLATES; t++)
+        {
+            memcpy(all + 4 * forest->template_start[t], segments[t], (size_t)forest->template_count[t] * 4 * sizeof(float));
+        }
+        upload_rgba_buffer(forest->segment_buffer, forest->segment_texture, (GLsizeiptr)total * 4 * sizeof(float), all, GL_STATIC_DRAW);
+        free(all);
+    }
+    else if (!last_status) last_status = PG_ALLOCATION_ERROR;
+
+    for (int t = 0; t < FOREST_TEMPLATES; t++) free(segments[t]);
+    return last_status;
+}
+
+// Scatter the trees, then sort them by tile with a counting sort
+static int plant_trees(forest_t* forest, uint32_t* seed)
+{
+    forest->tiles[0] = (int)ceilf(FOREST_WORLD_WIDTH / FOREST_TILE_SIZE);
+    forest->tiles[1] = (int)ceilf(FOREST_WORLD_HEIGHT / FOREST_TILE_SIZE);
+    int tile_count = forest->tiles[0] * forest->tiles[1];
+
+    forest->tree_count = FOREST_TREES;
+    forest->trees = (float*)malloc((size_t)FOREST_TREES * 4 * sizeof(float));
+    forest->tree_template = (int*)malloc((size_t)FOREST_TREES * sizeof(int));
+    forest->tile_start = (int*)calloc((size_t)tile_count + 1, sizeof(int));
+    forest->visible = (float*)malloc((size_t)FOREST_TREES * 4 * sizeof(float));
+    forest->visible_trees = (int*)malloc((size_t)FOREST_TREES * sizeof(int));
+    float* trees = (float*)malloc((size_t)FOREST_TREES * 4 * sizeof(float));
+    int* templates = (int*)malloc((size_t)FOREST_TREES * sizeof(int));
+    int* tiles = (int*)malloc((size_t)FOREST_TREES * sizeof(int));
+    int* cursor = (int*)malloc((size_t)tile_count * sizeof(int));
+    if (!forest->trees || !forest->tree_template || !forest->tile_start || !forest->visible || 
+        !forest->visible_trees || !trees || !templates || !tiles || !cursor)
+    {
+        free(trees);
+        free(templates);
+        free(tiles);
+        free(cursor);
+        return PG_ALLOCATION_ERROR;
+    }
+
+    forest->reach = 0.0f;
+    for (int i = 0; i < FOREST_TREES; i++)
+    {
+        float* tree = trees + 4 * i;
+        tree[0] = FOREST_WORLD_WIDTH * random_float(seed);
+        tree[1] = FOREST_WORLD_HEIGHT * random_float(seed);
+        tree[2] = random_range(seed, FOREST_MIN_SCALE, FOREST_MAX_SCALE);
+        tree[3] = random_float(seed) < 0.5f ? -1.0f : 1.0f;
+        templates[i] = (int)(random_float(seed) * FOREST_TEMPLATES);
+
+        const float* bounds = forest->template_bounds[templates[i]];
+        for (int k = 0; k < 4; k++) forest->reach = fmaxf(forest->reach, fabsf(bounds[k]) * tree[2]);
+
+        int x = (int)(tree[0] / FOREST_TILE_SIZE);
+        int y = (int)(tree[1] / FOREST_TILE_SIZE);
+        tiles[i] = y * forest->tiles[0] + x;
+        forest->tile_start[tiles[i] + 1]++;
+    }
+
+    for (int t = 0; t < tile_count; t++) forest->tile_start[t + 1] += forest->tile_start[t];
+
+    memcpy(cursor, forest->tile_start, (size_t)tile_count * sizeof(int));
+    for (int i = 0; i < FOREST_TREES; i++)
+    {
+        int j = cursor[tiles[i]]++;
+        memcpy(forest->trees + 4 * j, trees + 4 * i, 4 * sizeof(float));
+        forest->tree_template[j] = templates[i];
+    }
+
+    free(trees);
+    free(templates);
+    free(tiles);
+    free(cursor);
+    return PG_SUCCESS;
+}
+
+int init_forest(forest_t* forest, state_t* state)
+{
+    int last_status = PG_SUCCESS;
+
+    glGenBuffers(1, &forest->segment_buffer);
+    glGenTextures(1, &forest->segment_texture);
+    glGenBuffers(1, &forest->instance_buffer);
+    glGenTextures(1, &forest->instance_texture);
+    glGenVertexArrays(1, &forest->vao);
+
+    uint32_t seed = FOREST_SEED;
+    CHECK_CALL(generate_templates, forest, &seed);
+    CHECK_CALL(plant_trees, forest, &seed);
+
+    memset(forest->view, 0, sizeof(forest->view));
+    state->zoom = FOREST_ZOOM;
+    state->offset[0] = FOREST_WORLD_WIDTH * 0.5f;
+    state->offset[1] = FOREST_WORLD_HEIGHT * 0.5f;
+
+    printf("[>] Forest planted: %d trees over %dx%d tiles\n", forest->tree_count, forest->tiles[0], forest->tiles[1]);
+
+    return last_status;
+}
+
+// Gather the trees overlapping the view, grouped by template. Only the tiles
+// the view reaches, widened by the largest tree, are visited.
+static void cull_forest(forest_t* forest, const float* view)
+{
+    float pad = forest->reach + 2.0f * FOREST_THICKNESS;
+    int x0 = (int)floorf((view[0] - pad) / FOREST_TILE_SIZE);
+    int y0 = (int)floorf((view[1] - pad) / FOREST_TILE_SIZE);
+    int x1 = (int)floorf((view[2] + pad) / FOREST_TILE_SIZE);
+    int y1 = (int)floorf((view[3] + pad) / FOREST_TILE_SIZE);
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > forest->tiles[0] - 1) x1 = forest->tiles[0] - 1;
+    if (y1 > forest->tiles[1] - 1) y1 = forest->tiles[1] - 1;
+
+    int count = 0;
+    memset(forest->visible_count, 0, sizeof(forest->visible_count));
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            int tile = y * forest->tiles[0] + x;
+            for (int i = forest->tile_start[tile]; i < forest->tile_start[tile + 1]; i++)
+            {
+                const float* tree = forest->trees + 4 * i;
+                const float* bounds = forest->template_bounds[forest->tree_template[i]];
+                float left = tree[3] > 0.0f ? bounds[0] : -bounds[2];
+                float right = tree[3] > 0.0f ? bounds[2] : -bounds[0];
+
+                if (tree[0] + right * tree[2] + 2.0f * FOREST_THICKNESS < view[0] ||
+                    tree[0] + left * tree[2] - 2.0f * FOREST_THICKNESS > view[2] ||
+                    tree[1] + bounds[3] * tree[2] + 2.0f * FOREST_THICKNESS < view[1] ||
+                    tree[1] + bounds[1] * tree[2] - 2.0f * FOREST_THICKNESS > view[3])
+                {
+                    continue;
+                }
+
+                forest->visible_trees[count++] = i;
+                forest->visible_count[forest->tree_template[i]]++;
+            }
+        }
+    }
+
+    int start = 0;
+    for (int t = 0; t < FOREST_TEMPLATES; t++)
+    {
+        forest->visible_start[t] = start;
+        start += forest->visible_count[t];
+    }
+
+    int cursor[FOREST_TEMPLATES];
+    memcpy(cursor, forest->visible_start, sizeof(cursor));
+    for (int k = 0; k < count; k++)
+    {
+        int i = forest->visible_trees[k];
+        memcpy(forest->visible + 4 * cursor[forest->tree_template[i]]++, forest->trees + 4 * i, 4 * sizeof(float));
+    }
+
+    upload_rgba_buffer(forest->instance_buffer, forest->instance_texture, 
+        (GLsizeiptr)(count ? count : 1) * 4 * sizeof(float), forest->visible, GL_STREAM_DRAW);
+    PRINT("Forest: %d visible trees", count);
+}
+
+void draw_forest(forest_t* forest, GLuint program, const state_t* state, int width, int height)
+{
+    // the world rectangle on screen, trees are only culled again when it moves
+    float aspect = (float)state->width / (float)state->height;
+    float view[4] = 
+    {
+        state->offset[0] - 2.0f * aspect / state->zoom,
+        state->offset[1] - 2.0f / state->zoom,
+        state->offset[0] + 2.0f * aspect / state->zoom,
+        state->offset[1] + 2.0f / state->zoom,
+    };
+    if (memcmp(view, forest->view, sizeof(view)))
+    {
+        cull_forest(forest, view);
+        memcpy(forest->view, view, sizeof(view));
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)width, (float)height);
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], state->offset[1]);
+    glUniform1f(glGetUniformLocation(program, "zoom"), state->zoom);
+    glUniform1f(glGetUniformLocation(program, "thickness"), FOREST_THICKNESS);
+    glUniform3f(glGetUniformLocation(program, "color2"), 0.5, 1.0, 0.7);
+    glUniform1i(glGetUniformLocation(program, "segments"), 3);
+    glUniform1i(glGetUniformLocation(program, "trees"), 4);
+    GLint template_start_loc = glGetUniformLocation(program, "template_start");
+    GLint template_count_loc = glGetUniformLocation(program, "template_count");
+    GLint tree_start_loc = glGetUniformLocation(program, "tree_start");
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, forest->segment_texture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_BUFFER, forest->instance_texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(forest->vao);
+    for (int t = 0; t < FOREST_TEMPLATES; t++)
+    {
+        if (!forest->visible_count[t]) continue;
+
+        glUniform1i(template_start_loc, forest->template_start[t]);
+        glUniform1i(template_count_loc, forest->template_count[t]);
+        glUniform1i(tree_start_loc, forest->visible_start[t]);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, forest->template_count[t] * forest->visible_count[t]);
+    }
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
+
+void free_forest(forest_t* forest)
+{
+    free(forest->trees);
+    free(forest->tree_template);
+    free(forest->tile_start);
+    free(forest->visible);
+    free(forest->visible_trees);
+    forest->trees = NULL;
+    forest->tree_template = NULL;
+    forest->tile_start = NULL;
+    forest->visible = NULL;
+    forest->visible_trees = NULL;
+    if (forest->segment_buffer) glDeleteBuffers(1, &forest->segment_buffer);
+    if (forest->segment_texture) glDeleteTextures(1, &forest->segment_texture);
+    if (forest->instance_buffer) glDeleteBuffers(1, &forest->instance_buffer);
+    if (forest->instance_texture) glDeleteTextures(1, &forest->instance_texture);
+    if (forest->vao) glDeleteVertexArrays(1, &forest->vao);
+}
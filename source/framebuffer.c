@@ -0,0 +1,98 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/framebuffer.h"
+
+static GLenum pixel_format(GLenum internal_format)
+{
+    switch (internal_format)
+    {
+        case GL_R8:
+        case GL_R16F:
+        case GL_R32F:
+            return GL_RED;
+        case GL_RG16F:
+        case GL_RG32F:
+            return GL_RG;
+        case GL_RG32I:
+            return GL_RG_INTEGER;
+        default:
+            return GL_RGBA;
+    }
+}
+
+static GLenum pixel_type(GLenum internal_format)
+{
+    return internal_format == GL_RG32I ? GL_INT : GL_FLOAT;
+}
+
+// (Re)allocate the target only when its size or format changes,
+// so callers can call it every frame
+int resize_render_target(render_target_t* target, int width, int height, GLenum internal_format)
+{
+    int last_status = PG_SUCCESS;
+
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+
+    if (target->fbo && target->width == width && target->height == height && target->format == internal_format)
+    {
+        return last_status;
+    }
+
+    if (!target->fbo)
+    {
+        glGenFramebuffers(1, &target->fbo);
+        glGenTextures(1, &target->texture);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, target->texture);
+    GLenum type = pixel_type(internal_format);
+    GLint filter = type == GL_INT ? GL_NEAREST : GL_LINEAR;   // integer textures are only complete unfiltered
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, pixel_format(internal_format), type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->texture, 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        fprintf(stderr, "Framebuffer incomplete: 0x%x\n", status);
+        return PG_INITIALIZATION_ERROR;
+    }
+
+    target->width = width;
+    target->height = height;
+    target->format = internal_format;
+    PRINT("Render target resized to %dx%d", width, height);
+
+    return last_status;
+}
+
+void bind_render_target(render_target_t* target)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+    glViewport(0, 0, target->width, target->height);
+}
+
+void unbind_render_target(int width, int height)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+void delete_render_target(render_target_t* target)
+{
+    if (target->fbo) glDeleteFramebuffers(1, &target->fbo);
+    if (target->texture) glDeleteTextures(1, &target->texture);
+    target->fbo = 0;
+    target->texture = 0;
+    target->width = 0;
+    target->height = 0;
+}
@@ -0,0 +1,241 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/gradient.h"
+
+typedef struct gradient_stop_s
+{
+    double position;
+    double oklab[3];
+} gradient_stop_t;
+
+// Same matrices as color_space.glsl, by Björn Ottosson
+// https://bottosson.github.io/posts/oklab
+static const double linear_to_lms[3][3] =
+{
+    { 0.4121656120, 0.5362752080, 0.0514575653 },
+    { 0.2118591070, 0.6807189584, 0.1074065790 },
+    { 0.0883097947, 0.2818474174, 0.6302613616 },
+};
+
+static const double lms_to_oklab[3][3] =
+{
+    { 0.2104542553, 0.7936177850, -0.0040720468 },
+    { 1.9779984951, -2.4285922050, 0.4505937099 },
+    { 0.0259040371, 0.7827717662, -0.8086757660 },
+};
+
+static const double oklab_to_lms[3][3] =
+{
+    { 1.0, 0.396337777, 0.215803757 },
+    { 1.0, -0.105561346, -0.063854173 },
+    { 1.0, -0.089484178, -1.291485548 },
+};
+
+static const double lms_to_linear[3][3] =
+{
+    { 4.076724529, -3.307216883, 0.230759054 },
+    { -1.268143773, 2.609332323, -0.341134429 },
+    { -0.004111989, -0.703476310, 1.706862569 },
+};
+
+static void multiply(const double matrix[3][3], const double* in, double* out)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        out[i] = matrix[i][0] * in[0] + matrix[i][1] * in[1] + matrix[i][2] * in[2];
+    }
+}
+
+static void oklab_from_srgb(const uint8_t* srgb, double* oklab)
+{
+    double linear[3];
+    double lms[3];
+    for (int c = 0; c < 3; c++) linear[c] = pow(srgb[c] / 255.0, GRADIENT_GAMMA);
+    multiply(linear_to_lms, linear, lms);
+    for (int c = 0; c < 3; c++) lms[c] = cbrt(lms[c]);
+    multiply(lms_to_oklab, lms, oklab);
+}
+
+static void srgb_from_oklab(const double* oklab, uint8_t* srgb)
+{
+    double linear[3];
+    double lms[3];
+    multiply(oklab_to_lms, oklab, lms);
+    for (int c = 0; c < 3; c++) lms[c] = lms[c] * lms[c] * lms[c];
+    multiply(lms_to_linear, lms, linear);
+
+    for (int c = 0; c < 3; c++)
+    {
+        double value = linear[c] > 0.0 ? pow(linear[c], 1.0 / GRADIENT_GAMMA) : 0.0;
+        srgb[c] = (uint8_t)(value < 1.0 ? value * 255.0 + 0.5 : 255.0);
+    }
+}
+
+// Every texel of the row from the stops around it, stops are sorted by position
+static void bake_row(const gradient_stop_t* stops, int stop_count, uint8_t* row)
+{
+    for (int x = 0, s = 0; x < GRADIENT_WIDTH; x++)
+    {
+        double t = (double)x / (GRADIENT_WIDTH - 1);
+        while (s + 1 < stop_count && stops[s + 1].position <= t) s++;
+
+        double oklab[3];
+        const gradient_stop_t* low = &stops[s];
+        const gradient_stop_t* high = &stops[s + 1 < stop_count ? s + 1 : s];
+        double span = high->position - low->position;
+        double a = span > 0.0 ? (t - low->position) / span : 0.0;
+        if (a < 0.0) a = 0.0;
+        if (a > 1.0) a = 1.0;
+
+        for (int c = 0; c < 3; c++) oklab[c] = low->oklab[c] + (high->oklab[c] - low->oklab[c]) * a;
+        srgb_from_oklab(oklab, row + 4 * x);
+        row[4 * x + 3] = 255;
+    }
+}
+
+// One statement per line:
+//   gradient NAME starts a gradient, POSITION RRGGBB adds a stop to it.
+// Lines starting with # are comments.
+static int parse_gradients(gradient_t* gradient, const char* path, uint8_t* texels)
+{
+    int last_status = PG_SUCCESS;
+
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Error opening gradient file: %s\n", path);
+        return PG_ACCESS_DENIED;
+    }
+
+    gradient_stop_t stops[GRADIENT_MAX_STOPS];
+    int stop_count = 0;
+    char line[GRADIENT_MAX_LINE];
+    int line_number = 0;
+    gradient->count = 0;
+
+    while (!last_status)
+    {
+        int more = fgets(line, sizeof(line), file) != NULL;
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        const char* text = line;
+        while (isspace((unsigned char)*text)) text++;
+        if (more && (!*text || *text == '#')) continue;
+
+        int starts = more && !strncmp(text, "gradient", 8) && isspace((unsigned char)text[8]);
+        if (!more || starts)
+        {
+            // the gradient before is complete
+            if (gradient->count && stop_count < 2)
+            {
+                fprintf(stderr, "Gradient %s needs two stops at least: %s\n", gradient->names[gradient->count - 1], path);
+                last_status = PG_INVALID_PARAMETER;
+                break;
+            }
+            if (gradient->count)
+            {
+                bake_row(stops, stop_count, texels + (size_t)(gradient->count - 1) * GRADIENT_WIDTH * 4);
+            }
+            if (!more) break;
+
+            if (gradient->count == GRADIENT_MAX)
+            {
+                fprintf(stderr, "More than %d gradients in %s\n", GRADIENT_MAX, path);
+                last_status = PG_INSUFFICIENT_MEMORY;
+                break;
+            }
+
+            const char* name = text + 8;
+            while (isspace((unsigned char)*name)) name++;
+            snprintf(gradient->names[gradient->count], GRADIENT_NAME_LENGTH, "%s", name);
+            gradient->count++;
+            stop_count = 0;
+            continue;
+        }
+
+        unsigned int hex = 0;
+        char* end = NULL;
+        double position = strtod(text, &end);
+        if (!gradient->count || end == text || stop_count == GRADIENT_MAX_STOPS ||
+            position < 0.0 || position > 1.0 || (stop_count && position < stops[stop_count - 1].position) ||
+            (sscanf(end, " #%6x", &hex) != 1 && sscanf(end, " %6x", &hex) != 1))
+        {
+            fprintf(stderr, "Invalid gradient statement %s:%d: %s\n", path, line_number, text);
+            last_status = PG_INVALID_PARAMETER;
+            break;
+        }
+
+        uint8_t srgb[3] = { (uint8_t)(hex >> 16), (uint8_t)(hex >> 8), (uint8_t)hex };
+        stops[stop_count].position = position;
+        oklab_from_srgb(srgb, stops[stop_count].oklab);
+        stop_count++;
+    }
+
+    fclose(file);
+    if (!last_status && !gradient->count)
+    {
+        fprintf(stderr, "Gradient file without gradient: %s\n", path);
+        last_status = PG_INVALID_PARAMETER;
+    }
+
+    return last_status;
+}
+
+// Interpolate the stops of every gradient of the library in OKLab, once,
+// the shaders then read their color from the normalized escape time
+int init_gradient(gradient_t* gradient)
+{
+    int last_status = PG_SUCCESS;
+
+    if (!gradient->path) gradient->path = GRADIENT_DEFAULT_PATH;
+    gradient->current = -1;
+
+    uint8_t* texels = (uint8_t*)calloc((size_t)GRADIENT_MAX * GRADIENT_WIDTH * 4, sizeof(uint8_t));
+    if (!texels) return PG_ALLOCATION_ERROR;
+
+    last_status = parse_gradients(gradient, gradient->path, texels);
+    if (last_status)
+    {
+        free(texels);
+        return last_status;
+    }
+
+    glGenTextures(1, &gradient->texture);
+    glBindTexture(GL_TEXTURE_2D, gradient->texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, GRADIENT_WIDTH, gradient->count, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(texels);
+
+    printf("[>] %d gradients loaded from %s\n", gradient->count, gradient->path);
+
+    return last_status;
+}
+
+// Select a gradient for the program, the program becomes the one in use
+void bind_gradient(gradient_t* gradient, int index, GLuint program)
+{
+    index = index % gradient->count;
+    if (index != gradient->current)
+    {
+        printf("[>] Gradient: %s.\n", gradient->names[index]);
+        gradient->current = index;
+    }
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "gradient_texture"), GRADIENT_UNIT);
+    glUniform1f(glGetUniformLocation(program, "gradient_row"), (index + 0.5f) / gradient->count);
+    glActiveTexture(GL_TEXTURE0 + GRADIENT_UNIT);
+    glBindTexture(GL_TEXTURE_2D, gradient->texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void free_gradient(gradient_t* gradient)
+{
+    if (gradient->texture) glDeleteTextures(1, &gradient->texture);
+}
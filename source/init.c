@@ -4,6 +4,24 @@
 
 #include "../include/init.h"
 #include "../include/callbacks.h"
+#include "../include/resolution.h"
+#include "../include/checkerboard.h"
+#include "../include/iteration_budget.h"
+#include "../include/mandelbrot_compute.h"
+#include "../include/canopy.h"
+#include "../include/lsystem.h"
+#include "../include/forest.h"
+#include "../include/colonization.h"
+#include "../include/poisson.h"
+#include "../include/jump_flood.h"
+#include "../include/voronoi.h"
+#include "../include/postprocessing.h"
+#include "../include/gradient.h"
+#include "../include/edge_detection.h"
+#include "../include/framebuffer.h"
+#include "../include/tiled_image.h"
+#include "../include/virtual_texture.h"
+#include "../include/png_stream.h"
 
 static int init_data(int height, int width, data_t* data)
 {
@@ -17,7 +35,15 @@ static int init_data(int height, int width, data_t* data)
     data->state.is_dragging = 0;
     data->state.width = width;
     data->state.height = height;
+    data->state.last_interaction = 0.0;
     data->state.show_glow = 0;
+    data->state.dynamic_resolution = 1;
+    data->state.checkerboard = 0;
+    data->state.symmetry = 1;
+    data->state.compute_backend = 0;
+    data->state.canopy_raster = 0;
+    data->state.canopy_animate = 0;
+    init_canopy_params(&data->state.canopy);
 
     return last_status;
 }
@@ -101,7 +127,8 @@ static int init_vaovbo_image(GLuint* VAO, GLuint* VBO, GLuint* EBO)
     return last_status;
 }
 
-static int load_image(const char* path, image_t* image, state_t* state)
+// Decode an image flipped to the OpenGL orientation, the window takes its size when a state is given
+int load_image(const char* path, image_t* image, state_t* state)
 {
     int last_status = PG_SUCCESS;
 
@@ -116,19 +143,46 @@ static int load_image(const char* path, image_t* image, state_t* state)
     printf("[>] Image loaded successfully: %dx%d with %d channels\n", w, h, n_channels);
 
     // If your image has an alpha channel (4 channels), use GL_RGBA instead of GL_RGB
-    GLenum format = (n_channels == 4) ? GL_RGBA : GL_RGB;
+    GLenum format = (n_channels == 4) ? GL_RGBA : (n_channels == 3) ? GL_RGB : (n_channels == 2) ? GL_RG : GL_RED;
 
     image->buf = buf;
     image->width = w;
     image->height = h;
     image->format = format;
 
-    state->height = image->height;
-    state->width = image->width;
+    if (state)
+    {
+        state->height = image->height;
+        state->width = image->width;
+    }
 
     return last_status;
 }
 
+// Size of an image without decoding it, the window takes it
+static int read_image_size(const char* path, state_t* state)
+{
+    int n_channels;
+    if (!stbi_info(path, &state->width, &state->height, &n_channels)) return PG_EXTERNAL_ERROR;
+
+    return PG_SUCCESS;
+}
+
+static int image_channels(GLenum format)
+{
+    return format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+}
+
+// One and two channel images are stored as GL_RED / GL_RG, read them back as
+// gray and gray with alpha instead of red and red-green
+static void swizzle_gray(GLenum format)
+{
+    if (format != GL_RED && format != GL_RG) return;
+
+    GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, format == GL_RG ? GL_GREEN : GL_ONE };
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+}
+
 static int init_texture(GLuint* p_texture, image_t* image)
 {
     int last_status = PG_SUCCESS;
@@ -145,6 +199,7 @@ static int init_texture(GLuint* p_texture, image_t* image)
 
     glTexImage2D(GL_TEXTURE_2D, 0, image->format, image->width, image->height, 0, image->format, GL_UNSIGNED_BYTE, image->buf);
     glGenerateMipmap(GL_TEXTURE_2D);
+    swizzle_gray(image->format);
     stbi_image_free(image->buf);
 
     GLenum error = glGetError();
@@ -185,8 +240,8 @@ static int init_window(GLFWwindow** p_window, state_t* state)
     // for debug purpose
     printf("[>] GLFW Version: %s\n", glfwGetVersionString());
 
-    // OpenGL context hints
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    // OpenGL context hints, 4.3 enables compute shaders
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_SAMPLES, 4);
@@ -215,6 +270,13 @@ static int init_window(GLFWwindow** p_window, state_t* state)
     // Create window
     GLFWwindow* window = glfwCreateWindow(window_width, window_height, "Mandelbrot Set", NULL, NULL);
     if (!window)
+    {
+        printf("[>] OpenGL 4.3 context unavailable, falling back to 3.3\n");
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        window = glfwCreateWindow(window_width, window_height, "Mandelbrot Set", NULL, NULL);
+    }
+    if (!window)
     {
         fprintf(stderr, "Failed to create GLFW window\n");
         glfwTerminate();
@@ -241,6 +303,7 @@ static int init_window(GLFWwindow** p_window, state_t* state)
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetKeyCallback(window, key_callback);
 
     // enable MSAA
     glEnable(GL_MULTISAMPLE); 
@@ -253,6 +316,7 @@ int init(int height, int width, data_t* data)
     int last_status = PG_SUCCESS;
 
     image_t image = { 0 };
+    GLuint edge_texture = 0;
     CHECK_CALL(init_data, height, width, data);
 
     switch (data->flag & 1)
@@ -261,7 +325,12 @@ int init(int height, int width, data_t* data)
         break;
 
     case IMAGE:
-        CHECK_CALL(load_image, data->path, &image, &data->state);
+        // decoded once the context tells whether the image fits in a texture,
+        // a virtual texture keeps the default window whatever the image size
+        if (!data->virtual_texture.enabled)
+        {
+            CHECK_CALL(read_image_size, data->path, &data->state);
+        }
         break;
     
     default:
@@ -270,15 +339,84 @@ int init(int height, int width, data_t* data)
     }
     
     CHECK_CALL(init_window, &data->window, &data->state);
+    CHECK_CALL(init_postprocessing, &data->postprocessing);
 
     switch (data->flag & 1)
     {
     case PROCEDURAL:
         CHECK_CALL(init_vaovbo_generation, &data->vao, &data->vbo);
+        CHECK_CALL(init_dynamic_resolution, &data->dynres);
+        CHECK_CALL(init_checkerboard, &data->checkerboard);
+        CHECK_CALL(init_jump_flood, &data->jump_flood);
+        if ((data->flag >> 1) == MANDELBROT)
+        {
+            CHECK_CALL(init_iteration_budget, &data->budget);
+            CHECK_CALL(init_mandelbrot_compute, &data->compute);
+            CHECK_CALL(init_gradient, &data->gradient);
+            data->state.gradient_count = data->gradient.count;
+        }
+        else if ((data->flag >> 1) == CANOPY)
+        {
+            CHECK_CALL(init_canopy, &data->canopy);
+        }
+        else if ((data->flag >> 1) == LSYSTEM)
+        {
+            CHECK_CALL(init_lsystem, &data->lsystem, data->path);
+        }
+        else if ((data->flag >> 1) == FOREST)
+        {
+            CHECK_CALL(init_forest, &data->forest, &data->state);
+        }
+        else if ((data->flag >> 1) == COLONIZATION)
+        {
+            CHECK_CALL(init_colonization, &data->colonization);
+        }
+        else if ((data->flag >> 1) == POISSON)
+        {
+            CHECK_CALL(init_poisson, &data->poisson, data->path, &data->state);
+        }
+        else if ((data->flag >> 1) == VORONOI)
+        {
+            CHECK_CALL(init_voronoi, &data->voronoi, &data->state);
+        }
         break;
 
     case IMAGE:
-        CHECK_CALL(init_texture,  &data->texture, &image);
+        if (data->virtual_texture.enabled)
+        {
+            // pages are streamed every frame, the image is never decoded whole
+            CHECK_CALL(init_virtual_texture, &data->virtual_texture, data->path);
+            CHECK_CALL(init_vaovbo_image, &data->vao, &data->vbo, &data->ebo);
+            break;
+        }
+
+        CHECK_CALL(init_tiled_image, &data->tiled, data->state.width, data->state.height);
+        if (data->tiled.active)
+        {
+            // nothing is displayed, the tiles are post-processed offscreen then written
+            glfwHideWindow(data->window);
+            CHECK_CALL(init_vaovbo_generation, &data->vao, &data->vbo);
+            break;
+        }
+
+        if (can_stream_png(data->path))
+        {
+            // decoded straight into pixel buffers, the pixels are never in memory
+            // whole, so the edge map is computed once from the texture
+            CHECK_CALL(stream_png_texture, data->path, &image, &data->texture);
+            glBindTexture(GL_TEXTURE_2D, data->texture);
+            swizzle_gray(image.format);
+            CHECK_CALL(detect_edges, &data->postprocessing.edges, data->texture, image.width, image.height, &edge_texture);
+            unbind_render_target(data->state.width, data->state.height);
+        }
+        else
+        {
+            CHECK_CALL(load_image, data->path, &image, NULL);
+            // the image never goes through the render graph, its edge map is computed
+            // once on the CPU while the pixels are still in memory
+            CHECK_CALL(upload_edges, &data->postprocessing.edges, image.buf, image.width, image.height, image_channels(image.format));
+            CHECK_CALL(init_texture,  &data->texture, &image);
+        }
         CHECK_CALL(init_vaovbo_image, &data->vao, &data->vbo, &data->ebo);
         break;
     
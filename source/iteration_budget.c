@@ -0,0 +1,238 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/iteration_budget.h"
+#include "../include/framebuffer.h"
+
+// Previous zoom only heuristic, kept as the initial budget and as the probe reference
+static float legacy_iterations(float zoom)
+{
+    return BUDGET_BASE_ITERATIONS * (1.0f + logf(zoom + 1.0f));
+}
+
+static void upload_tiles(iteration_budget_t* budget)
+{
+    glBindTexture(GL_TEXTURE_2D, budget->tile_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BUDGET_TILES_X, BUDGET_TILES_Y, GL_RED, GL_FLOAT, budget->tile_iterations);
+}
+
+int init_iteration_budget(iteration_budget_t* budget)
+{
+    int last_status = PG_SUCCESS;
+
+    // keep values given on the command line
+    if (budget->fraction <= 0.0f || budget->fraction > 1.0f) budget->fraction = BUDGET_DEFAULT_FRACTION;
+    budget->iterations = legacy_iterations(1.0f);
+    budget->reported = 0.0f;
+    budget->fence = NULL;
+
+    for (int i = 0; i < BUDGET_TILES_X * BUDGET_TILES_Y; i++)
+    {
+        budget->tile_iterations[i] = budget->iterations;
+    }
+
+    glGenBuffers(1, &budget->pbo);
+    glGenTextures(1, &budget->tile_texture);
+    glBindTexture(GL_TEXTURE_2D, budget->tile_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, BUDGET_TILES_X, BUDGET_TILES_Y, 0, GL_RED, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    upload_tiles(budget);
+
+    return last_status;
+}
+
+static int compare_float(const void* a, const void* b)
+{
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Smallest budget resolving the requested fraction of the escaping samples
+static float budget_from_counts(float* counts, int n, float fraction, float fallback, float cap)
+{
+    if (n == 0) return fallback;
+
+    qsort(counts, n, sizeof(float), compare_float);
+    int index = (int)ceilf(fraction * n) - 1;
+    if (index < 0) index = 0;
+    if (index > n - 1) index = n - 1;
+
+    // margin for the filaments the sparse probe misses
+    float iterations = ceilf((counts[index] + 1.0f) * BUDGET_MARGIN);
+    if (iterations < BUDGET_MIN_ITERATIONS) iterations = BUDGET_MIN_ITERATIONS;
+    if (iterations > cap) iterations = cap;
+
+    return iterations;
+}
+
+// Probe texels hold the escape count and whether the sample escaped at all
+static int read_probe(iteration_budget_t* budget)
+{
+    int last_status = PG_SUCCESS;
+
+    int w = budget->probe.width;
+    int h = budget->probe.height;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, budget->pbo);
+    const float* texels = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, w * h * 2 * sizeof(float), GL_MAP_READ_BIT);
+    if (!texels)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return PG_EXTERNAL_ERROR;
+    }
+
+    float* counts = (float*)malloc(w * h * sizeof(float));
+    if (!counts)
+    {
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return PG_ALLOCATION_ERROR;
+    }
+
+    // frame budget over every escaping sample
+    int n = 0;
+    for (int i = 0; i < w * h; i++)
+    {
+        if (texels[2 * i + 1] > 0.5f) counts[n++] = texels[2 * i];
+    }
+    float frame = budget_from_counts(counts, n, budget->fraction, budget->probe_cap, budget->probe_cap);
+
+    // tile budgets, tiles without escaping samples fall back to the frame budget
+    for (int ty = 0; ty < BUDGET_TILES_Y; ty++)
+    {
+        for (int tx = 0; tx < BUDGET_TILES_X; tx++)
+        {
+            n = 0;
+            for (int y = ty * h / BUDGET_TILES_Y; y < (ty + 1) * h / BUDGET_TILES_Y; y++)
+            {
+                for (int x = tx * w / BUDGET_TILES_X; x < (tx + 1) * w / BUDGET_TILES_X; x++)
+                {
+                    int i = y * w + x;
+                    if (texels[2 * i + 1] > 0.5f) counts[n++] = texels[2 * i];
+                }
+            }
+            budget->tile_iterations[ty * BUDGET_TILES_X + tx] = budget_from_counts(counts, n, budget->fraction, frame, frame);
+        }
+    }
+
+    // estimated work against the legacy budget, from the same samples
+    float legacy = legacy_iterations(budget->probe_view[0]);
+    double legacy_cost = 0.0;
+    double budget_cost = 0.0;
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            int i = y * w + x;
+            float limit = frame;
+            if (budget->per_tile)
+            {
+                limit = budget->tile_iterations[(y * BUDGET_TILES_Y / h) * BUDGET_TILES_X + x * BUDGET_TILES_X / w];
+            }
+
+            float needed = (texels[2 * i + 1] > 0.5f) ? texels[2 * i] + 1.0f : budget->probe_cap;
+            legacy_cost += fminf(needed, legacy);
+            budget_cost += fminf(needed, limit);
+        }
+    }
+
+    free(counts);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    budget->iterations = frame;
+    upload_tiles(budget);
+
+    if (fabsf(frame - budget->reported) > BUDGET_REPORT_CHANGE * budget->reported)
+    {
+        printf("[>] Iteration budget %.0f (legacy %.0f), %.0f%% of the iterations saved\n",
+            frame, legacy, 100.0 * (1.0 - budget_cost / legacy_cost));
+        budget->reported = frame;
+    }
+
+    return last_status;
+}
+
+// Render escape counts of a sparse grid with a generous cap and read them back asynchronously
+static int run_probe(iteration_budget_t* budget, state_t* state, GLuint program, GLuint vao, const float view[4])
+{
+    int last_status = PG_SUCCESS;
+
+    int width = BUDGET_PROBE_WIDTH;
+    int height = (int)(width * (float)state->height / (float)state->width + 0.5f);
+    CHECK_CALL(resize_render_target, &budget->probe, width, height, GL_RG32F);
+    bind_render_target(&budget->probe);
+
+    budget->probe_cap = BUDGET_PROBE_FACTOR * legacy_iterations(state->zoom);
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)budget->probe.width, (float)budget->probe.height);
+    glUniform1f(glGetUniformLocation(program, "zoom"), state->zoom);
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], state->offset[1]);
+    glUniform1f(glGetUniformLocation(program, "max_iterations"), budget->probe_cap);
+    glUniform1i(glGetUniformLocation(program, "checkerboard_parity"), -1);
+    glUniform1i(glGetUniformLocation(program, "use_tile_budget"), 0);
+    glUniform1i(glGetUniformLocation(program, "probe"), 1);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glUniform1i(glGetUniformLocation(program, "probe"), 0);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, budget->pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, budget->probe.width * budget->probe.height * 2 * sizeof(float), NULL, GL_STREAM_READ);
+    glReadPixels(0, 0, budget->probe.width, budget->probe.height, GL_RG, GL_FLOAT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    budget->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    unbind_render_target(state->width, state->height);
+    memcpy(budget->probe_view, view, sizeof(budget->probe_view));
+
+    return last_status;
+}
+
+// Collect a finished probe, start a new one if the view changed,
+// then set the budget uniforms of the Mandelbrot program
+int update_iteration_budget(iteration_budget_t* budget, state_t* state, GLuint program, GLuint vao)
+{
+    int last_status = PG_SUCCESS;
+
+    if (budget->fence)
+    {
+        GLenum wait = glClientWaitSync(budget->fence, 0, 0);
+        if (wait == GL_ALREADY_SIGNALED || wait == GL_CONDITION_SATISFIED)
+        {
+            glDeleteSync(budget->fence);
+            budget->fence = NULL;
+            CHECK_CALL(read_probe, budget);
+        }
+    }
+
+    float view[4] = { state->zoom, state->offset[0], state->offset[1], (float)state->width / (float)state->height };
+    if (!budget->fence && memcmp(view, budget->probe_view, sizeof(view)))
+    {
+        CHECK_CALL(run_probe, budget, state, program, vao, view);
+    }
+
+    glUseProgram(program);
+    glUniform1f(glGetUniformLocation(program, "max_iterations"), budget->iterations);
+    glUniform1i(glGetUniformLocation(program, "use_tile_budget"), budget->per_tile);
+    glUniform1i(glGetUniformLocation(program, "tile_budget"), 2);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, budget->tile_texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    return last_status;
+}
+
+void free_iteration_budget(iteration_budget_t* budget)
+{
+    if (budget->fence) glDeleteSync(budget->fence);
+    if (budget->pbo) glDeleteBuffers(1, &budget->pbo);
+    if (budget->tile_texture) glDeleteTextures(1, &budget->tile_texture);
+    delete_render_target(&budget->probe);
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/jump_flood.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+
+int init_jump_flood(jump_flood_t* jump_flood)
+{
+    int last_status = PG_SUCCESS;
+
+    jump_flood->current = 0;
+    jump_flood->pair = 0;
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_jump_flood_seed.glsl", &jump_flood->seed_program);
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_jump_flood_step.glsl", &jump_flood->step_program);
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_jump_flood_effect.glsl", &jump_flood->effect_program);
+
+    return last_status;
+}
+
+// Bind an empty field, callers then draw their seeds in it. GL_RG32F fields hold
+// the pixel coordinates of the seeds, GL_RG32I fields any integer the caller floods.
+int begin_jump_flood_seeds(jump_flood_t* jump_flood, int width, int height, GLenum format)
+{
+    int last_status = PG_SUCCESS;
+
+    // pixel coordinates must stay exact, half floats lose them past 2048
+    render_target_t* field = jump_flood->field[format == GL_RG32I];
+    CHECK_CALL(resize_render_target, &field[0], width, height, format);
+    CHECK_CALL(resize_render_target, &field[1], width, height, format);
+
+    jump_flood->pair = format == GL_RG32I;
+    jump_flood->current = 0;
+    bind_render_target(&field[0]);
+    if (format == GL_RG32I)
+    {
+        const GLint empty[4] = { -1, -1, -1, -1 };
+        glClearBufferiv(GL_COLOR, 0, empty);
+    }
+    else
+    {
+        glClearColor(-1.0f, -1.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    return last_status;
+}
+
+// Seed every pixel of the texture brighter than the threshold
+int seed_jump_flood(jump_flood_t* jump_flood, GLuint texture, float threshold, int width, int height, GLuint vao)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(begin_jump_flood_seeds, jump_flood, width, height, GL_RG32F);
+
+    GLuint program = jump_flood->seed_program;
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "source_texture"), 0);
+    glUniform1f(glGetUniformLocation(program, "threshold"), threshold);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    return last_status;
+}
+
+// Flood the seeds up to reach pixels away, the whole field when reach is not positive.
+// Steps halve from the power of two above the reach down to one pixel, so the cost is
+// log2(reach) full screen passes whatever the number of seeds. A last one pixel step
+// fixes most of the pixels the halving steps got wrong.
+// The step program reads the field on unit 0, callers set its other uniforms beforehand.
+void run_jump_flood(jump_flood_t* jump_flood, GLuint program, int reach, GLuint vao, GLuint* field)
+{
+    render_target_t* field_pair = jump_flood->field[jump_flood->pair];
+    int width = field_pair[0].width;
+    int height = field_pair[0].height;
+    if (reach <= 0) reach = width > height ? width : height;
+
+    int first_step = 1;
+    while (first_step <= reach) first_step <<= 1;
+    first_step >>= 1;
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "field_texture"), 0);
+    GLint jump_loc = glGetUniformLocation(program, "jump");
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(vao);
+
+    for (int step = first_step; step >= 0; step >>= 1)
+    {
+        int source = jump_flood->current;
+        int destination = 1 - source;
+
+        bind_render_target(&field_pair[destination]);
+        glUniform1i(jump_loc, step > 0 ? step : 1);
+        glBindTexture(GL_TEXTURE_2D, field_pair[source].texture);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        jump_flood->current = destination;
+        if (step == 0) break;
+    }
+
+    *field = field_pair[jump_flood->current].texture;
+}
+
+// Outline, glow or thicken the bright shapes of the texture, width is in pixels.
+// Only the reach of the effect is flooded, its cost does not grow with the resolution.
+int apply_distance_effect(jump_flood_t* jump_flood, int effect, float width, GLuint texture,
+    int render_width, int render_height, GLuint vao, GLuint* output)
+{
+    int last_status = PG_SUCCESS;
+
+    if (effect == EFFECT_NONE)
+    {
+        *output = texture;
+        return last_status;
+    }
+
+    float reach = effect == EFFECT_GLOW ? width * JUMP_FLOOD_GLOW_REACH : width + 1.0f;
+    GLuint field = 0;
+    CHECK_CALL(seed_jump_flood, jump_flood, texture, JUMP_FLOOD_SEED_THRESHOLD, render_width, render_height, vao);
+    run_jump_flood(jump_flood, jump_flood->step_program, (int)ceilf(reach), vao, &field);
+
+    CHECK_CALL(resize_render_target, &jump_flood->output, render_width, render_height, GL_RGBA8);
+    bind_render_target(&jump_flood->output);
+
+    GLuint program = jump_flood->effect_program;
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "source_texture"), 0);
+    glUniform1i(glGetUniformLocation(program, "field_texture"), 1);
+    glUniform1i(glGetUniformLocation(program, "effect"), effect);
+    glUniform1f(glGetUniformLocation(program, "width"), width);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, field);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glActiveTexture(GL_TEXTURE0);
+
+    *output = jump_flood->output.texture;
+
+    return last_status;
+}
+
+const char* distance_effect_name(int effect)
+{
+    switch (effect)
+    {
+        case EFFECT_OUTLINE: return "outline";
+        case EFFECT_GLOW: return "glow";
+        case EFFECT_STROKE: return "thick stroke";
+        default: return "none";
+    }
+}
+
+void free_jump_flood(jump_flood_t* jump_flood)
+{
+    if (jump_flood->seed_program) glDeleteProgram(jump_flood->seed_program);
+    if (jump_flood->step_program) glDeleteProgram(jump_flood->step_program);
+    if (jump_flood->effect_program) glDeleteProgram(jump_flood->effect_program);
+    for (int pair = 0; pair < 2; pair++)
+    {
+        delete_render_target(&jump_flood->field[pair][0]);
+        delete_render_target(&jump_flood->field[pair][1]);
+    }
+    delete_render_target(&jump_flood->output);
+}
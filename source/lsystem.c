@@ -0,0 +1,342 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/lsystem.h"
+
+typedef struct frame_s
+{
+    const char* symbols;
+    int level;
+} frame_t;
+
+typedef struct turtle_s
+{
+    double x;
+    double y;
+    double dx;
+    double dy;
+} turtle_t;
+
+static int is_drawing(char symbol)
+{
+    return symbol == 'F' || symbol == 'G';
+}
+
+// Copy the symbols of a line into the arena, whitespace is not part of the alphabet
+static int copy_symbols(arena_t* arena, const char* text, const char** p_symbols)
+{
+    int last_status = PG_SUCCESS;
+
+    char* symbols = NULL;
+    CHECK_CALL(arena_alloc, arena, strlen(text) + 1, (void**)&symbols);
+
+    char* out = symbols;
+    for (; *text; text++)
+    {
+        if (!isspace((unsigned char)*text)) *out++ = *text;
+    }
+    *out = '\0';
+
+    *p_symbols = symbols;
+    return last_status;
+}
+
+static const char* skip_spaces(const char* text)
+{
+    while (isspace((unsigned char)*text)) text++;
+    return text;
+}
+
+// One statement per line:
+//   axiom SYMBOLS, angle DEGREES, iterations N, thickness T, or a rule X -> SYMBOLS.
+// Lines starting with # are comments.
+static int parse_grammar(lsystem_t* lsystem, const char* path)
+{
+    int last_status = PG_SUCCESS;
+
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Error opening L-system file: %s\n", path);
+        return PG_ACCESS_DENIED;
+    }
+
+    char line[LSYSTEM_MAX_LINE];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        const char* text = skip_spaces(line);
+        if (!*text || *text == '#') continue;
+
+        if (!strncmp(text, "axiom", 5) && isspace((unsigned char)text[5]))
+        {
+            last_status = copy_symbols(&lsystem->arena, text + 5, &lsystem->axiom);
+        }
+        else if (!strncmp(text, "angle", 5) && isspace((unsigned char)text[5]))
+        {
+            lsystem->angle = strtof(text + 5, NULL);
+        }
+        else if (!strncmp(text, "iterations", 10) && isspace((unsigned char)text[10]))
+        {
+            lsystem->iterations = (int)strtol(text + 10, NULL, 10);
+            if (lsystem->iterations < 0 || lsystem->iterations > LSYSTEM_MAX_ITERATIONS) last_status = PG_INVALID_PARAMETER;
+        }
+        else if (!strncmp(text, "thickness", 9) && isspace((unsigned char)text[9]))
+        {
+            lsystem->thickness = strtof(text + 9, NULL);
+        }
+        else
+        {
+            const char* arrow = skip_spaces(text + 1);
+            if (strncmp(arrow, "->", 2)) last_status = PG_INVALID_PARAMETER;
+            else last_status = copy_symbols(&lsystem->arena, arrow + 2, &lsystem->rules[(unsigned char)*text]);
+        }
+
+        if (last_status)
+        {
+            fprintf(stderr, "Invalid L-system statement %s:%d: %s\n", path, line_number, text);
+            break;
+        }
+    }
+
+    fclose(file);
+    if (!last_status && !lsystem->axiom)
+    {
+        fprintf(stderr, "L-system file without axiom: %s\n", path);
+        last_status = PG_INVALID_PARAMETER;
+    }
+
+    return last_status;
+}
+
+// Number of segments drawn by each symbol once expanded, level by level:
+// counts[k][c] is for the symbol c with k rewrites left. Saturates instead of overflowing.
+static int count_segments(lsystem_t* lsystem, uint64_t* p_count)
+{
+    int last_status = PG_SUCCESS;
+
+    size_t mark = arena_mark(&lsystem->arena);
+    uint64_t* counts = NULL;
+    CHECK_CALL(arena_alloc, &lsystem->arena, (size_t)(lsystem->iterations + 1) * LSYSTEM_SYMBOLS * sizeof(uint64_t), (void**)&counts);
+
+    for (int c = 0; c < LSYSTEM_SYMBOLS; c++)
+    {
+        counts[c] = is_drawing((char)c);
+    }
+
+    for (int k = 1; k <= lsystem->iterations; k++)
+    {
+        const uint64_t* previous = counts + (size_t)(k - 1) * LSYSTEM_SYMBOLS;
+        uint64_t* current = counts + (size_t)k * LSYSTEM_SYMBOLS;
+        for (int c = 0; c < LSYSTEM_SYMBOLS; c++)
+        {
+            const char* rule = lsystem->rules[c];
+            if (!rule)
+            {
+                current[c] = counts[c];
+                continue;
+            }
+
+            uint64_t sum = 0;
+            for (; *rule; rule++)
+            {
+                uint64_t n = previous[(unsigned char)*rule];
+                sum = (sum > UINT64_MAX - n) ? UINT64_MAX : sum + n;
+            }
+            current[c] = sum;
+        }
+    }
+
+    const uint64_t* last = counts + (size_t)lsystem->iterations * LSYSTEM_SYMBOLS;
+    uint64_t total = 0;
+    for (const char* symbol = lsystem->axiom; *symbol; symbol++)
+    {
+        uint64_t n = last[(unsigned char)*symbol];
+        total = (total > UINT64_MAX - n) ? UINT64_MAX : total + n;
+    }
+
+    arena_reset(&lsystem->arena, mark);
+    *p_count = total;
+    return last_status;
+}
+
+// Expand the axiom depth first with an explicit stack of partially read rules,
+// one frame per rewrite level, and feed every terminal symbol to the turtle.
+// The expanded string is never stored, memory is bounded by iterations and nesting.
+static int expand(lsystem_t* lsystem, float* out, double* bounds)
+{
+    int last_status = PG_SUCCESS;
+
+    size_t mark = arena_mark(&lsystem->arena);
+    frame_t* frames = NULL;
+    turtle_t* saved = NULL;
+    CHECK_CALL(arena_alloc, &lsystem->arena, (size_t)(lsystem->iterations + 1) * sizeof(frame_t), (void**)&frames);
+    CHECK_CALL(arena_alloc, &lsystem->arena, LSYSTEM_MAX_NESTING * sizeof(turtle_t), (void**)&saved);
+
+    double radians = lsystem->angle * M_PI / 180.0;
+    double c = cos(radians);
+    double s = sin(radians);
+    turtle_t turtle = { 0.0, 0.0, 0.0, 1.0 };
+    int nesting = 0;
+    GLsizei written = 0;
+    bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0.0;
+
+    int top = 0;
+    frames[0].symbols = lsystem->axiom;
+    frames[0].level = 0;
+    while (top >= 0)
+    {
+        frame_t* frame = frames + top;
+        char symbol = *frame->symbols;
+        if (!symbol)
+        {
+            top--;
+            continue;
+        }
+        frame->symbols++;
+
+        const char* rule = lsystem->rules[(unsigned char)symbol];
+        if (rule && frame->level < lsystem->iterations)
+        {
+            frames[top + 1].symbols = rule;
+            frames[top + 1].level = frame->level + 1;
+            top++;
+            continue;
+        }
+
+        double dx = turtle.dx;
+        switch (symbol)
+        {
+            case 'F':
+            case 'G':
+            case 'f':
+                if (symbol != 'f')
+                {
+                    float* segment = out + 4 * (size_t)written++;
+                    segment[0] = (float)turtle.x;
+                    segment[1] = (float)turtle.y;
+                    segment[2] = (float)(turtle.x + turtle.dx);
+                    segment[3] = (float)(turtle.y + turtle.dy);
+                }
+                turtle.x += turtle.dx;
+                turtle.y += turtle.dy;
+                bounds[0] = fmin(bounds[0], turtle.x);
+                bounds[1] = fmin(bounds[1], turtle.y);
+                bounds[2] = fmax(bounds[2], turtle.x);
+                bounds[3] = fmax(bounds[3], turtle.y);
+                break;
+
+            case '+':
+                turtle.dx = c * dx - s * turtle.dy;
+                turtle.dy = s * dx + c * turtle.dy;
+                break;
+
+            case '-':
+                turtle.dx = c * dx + s * turtle.dy;
+                turtle.dy = -s * dx + c * turtle.dy;
+                break;
+
+            case '|':
+                turtle.dx = -turtle.dx;
+                turtle.dy = -turtle.dy;
+                break;
+
+            case '[':
+                if (nesting == LSYSTEM_MAX_NESTING)
+                {
+                    fprintf(stderr, "L-system branches nested deeper than %d\n", LSYSTEM_MAX_NESTING);
+                    arena_reset(&lsystem->arena, mark);
+                    return PG_INSUFFICIENT_MEMORY;
+                }
+                saved[nesting++] = turtle;
+                break;
+
+            case ']':
+                if (nesting == 0)
+                {
+                    fprintf(stderr, "L-system closes a branch that was never opened\n");
+                    arena_reset(&lsystem->arena, mark);
+                    return PG_INVALID_PARAMETER;
+                }
+                turtle = saved[--nesting];
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    arena_reset(&lsystem->arena, mark);
+    return last_status;
+}
+
+int init_lsystem(lsystem_t* lsystem, const char* path)
+{
+    int last_status = PG_SUCCESS;
+
+    memset(lsystem->rules, 0, sizeof(lsystem->rules));
+    lsystem->axiom = NULL;
+    lsystem->iterations = LSYSTEM_DEFAULT_ITERATIONS;
+    lsystem->angle = LSYSTEM_DEFAULT_ANGLE;
+    lsystem->thickness = LSYSTEM_DEFAULT_THICKNESS;
+    lsystem->segment_count = 0;
+
+    CHECK_CALL(init_arena, &lsystem->arena, LSYSTEM_ARENA_SIZE);
+    CHECK_CALL(parse_grammar, lsystem, path);
+
+    uint64_t count = 0;
+    CHECK_CALL(count_segments, lsystem, &count);
+    if (count > LSYSTEM_MAX_SEGMENTS)
+    {
+        fprintf(stderr, "L-system too large: %llu segments, at most %d\n", (unsigned long long)count, LSYSTEM_MAX_SEGMENTS);
+        return PG_INSUFFICIENT_MEMORY;
+    }
+
+    // the turtle writes straight into the vertex buffer, sized by the count pass
+    glGenBuffers(1, &lsystem->buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, lsystem->buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)((count ? count : 1) * 4 * sizeof(float)), NULL, GL_STATIC_DRAW);
+
+    double bounds[4] = { 0.0 };
+    if (count)
+    {
+        float* out = (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * 4 * sizeof(float)), 
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!out) return PG_EXTERNAL_ERROR;
+
+        last_status = expand(lsystem, out, bounds);
+        if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE && !last_status) last_status = PG_EXTERNAL_ERROR;
+        if (last_status) return last_status;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    lsystem->segment_count = (GLsizei)count;
+
+    // fit the drawing in the view
+    double extent = fmax(bounds[2] - bounds[0], bounds[3] - bounds[1]);
+    float scale = extent > 0.0 ? (float)(LSYSTEM_FIT / extent) : 1.0f;
+    lsystem->transform[0] = scale;
+    lsystem->transform[1] = scale;
+    lsystem->transform[2] = -(float)(bounds[0] + bounds[2]) * 0.5f * scale;
+    lsystem->transform[3] = -(float)(bounds[1] + bounds[3]) * 0.5f * scale;
+
+    printf("[>] L-system expanded: %d iterations, %d segments\n", lsystem->iterations, lsystem->segment_count);
+
+    CHECK_CALL(init_segment_renderer, &lsystem->renderer, lsystem->buffer);
+
+    return last_status;
+}
+
+void draw_lsystem(lsystem_t* lsystem, GLuint program, int width, int height)
+{
+    draw_segments(&lsystem->renderer, program, lsystem->segment_count, lsystem->thickness, lsystem->transform, width, height);
+}
+
+void free_lsystem(lsystem_t* lsystem)
+{
+    free_arena(&lsystem->arena);
+    free_segment_renderer(&lsystem->renderer);
+    if (lsystem->buffer) glDeleteBuffers(1, &lsystem->buffer);
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/mandelbrot_compute.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+
+// Compute backend needs a GL 4.3 context, the fragment path stays the fallback
+int init_mandelbrot_compute(mandelbrot_compute_t* compute)
+{
+    int last_status = PG_SUCCESS;
+
+    compute->available = GLEW_VERSION_4_3 ? 1 : 0;
+    if (!compute->available)
+    {
+        printf("[>] OpenGL 4.3 unavailable, Mandelbrot compute backend disabled.\n");
+        return last_status;
+    }
+
+    CHECK_CALL(create_compute_program, "shaders/compute_mandelbrot.comp", &compute->program);
+
+    GLuint zero = 0;
+    glGenBuffers(1, &compute->queue);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, compute->queue);
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+    return last_status;
+}
+
+// Shade the rows of the band, or every row without one, into compute->target
+int dispatch_mandelbrot_compute(mandelbrot_compute_t* compute, state_t* state, iteration_budget_t* budget, 
+    int width, int height, float offset_y, const mirror_band_t* band)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(resize_render_target, &compute->target, width, height, GL_RGBA8);
+
+    int first_row = band ? band->render_y0 : 0;
+    int last_row = band ? band->render_y1 : height;
+    int tile_columns = (width + COMPUTE_TILE_SIZE - 1) / COMPUTE_TILE_SIZE;
+    int tile_rows = (last_row - first_row + COMPUTE_TILE_SIZE - 1) / COMPUTE_TILE_SIZE;
+    int tile_count = tile_columns * tile_rows;
+
+    // reset the work queue
+    GLuint zero = 0;
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, compute->queue);
+    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &zero);
+    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, compute->queue);
+
+    GLuint program = compute->program;
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)width, (float)height);
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], offset_y);
+    glUniform1f(glGetUniformLocation(program, "zoom"), state->zoom);
+    glUniform1f(glGetUniformLocation(program, "time"), glfwGetTime());
+    glUniform1i(glGetUniformLocation(program, "show_glow"), state->show_glow);
+    glUniform1f(glGetUniformLocation(program, "max_iterations"), budget->iterations);
+    glUniform1i(glGetUniformLocation(program, "use_tile_budget"), budget->per_tile);
+    glUniform1i(glGetUniformLocation(program, "tile_budget"), 2);
+    glUniform1i(glGetUniformLocation(program, "first_row"), first_row);
+    glUniform1i(glGetUniformLocation(program, "tile_columns"), tile_columns);
+    glUniform1i(glGetUniformLocation(program, "tile_count"), tile_count);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, budget->tile_texture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindImageTexture(0, compute->target.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+    // a fixed set of workgroups, never more than there are tiles
+    int groups = tile_count < COMPUTE_PERSISTENT_GROUPS ? tile_count : COMPUTE_PERSISTENT_GROUPS;
+    if (groups > 0)
+    {
+        glDispatchCompute(groups, 1, 1);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+
+    return last_status;
+}
+
+void free_mandelbrot_compute(mandelbrot_compute_t* compute)
+{
+    if (compute->program) glDeleteProgram(compute->program);
+    if (compute->queue) glDeleteBuffers(1, &compute->queue);
+    delete_render_target(&compute->target);
+}
@@ -0,0 +1,564 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/palette.h"
+
+// Palette being fitted, channels stored apart so four colors are compared at once.
+// Unused slots up to the padded size sit far away from every pixel.
+typedef struct palette_s
+{
+    int size;
+    int padded;
+    float r[PALETTE_MAX_COLORS];
+    float g[PALETTE_MAX_COLORS];
+    float b[PALETTE_MAX_COLORS];
+} palette_t;
+
+// Color sums of every palette entry, one set per thread merged in thread order
+typedef struct palette_sums_s
+{
+    int64_t r[PALETTE_MAX_COLORS];
+    int64_t g[PALETTE_MAX_COLORS];
+    int64_t b[PALETTE_MAX_COLORS];
+    int64_t count[PALETTE_MAX_COLORS];
+} palette_sums_t;
+
+// Distinct colors of a set of pixels, sorted, with the number of pixels of each.
+// Images hold far fewer colors than pixels, dithered ones especially.
+typedef struct color_set_s
+{
+    int count;
+    uint32_t* packed;
+    uint8_t* rgb;
+    int* weights;
+} color_set_t;
+
+// Slice of the colors for one thread, either mapped to indices or summed, or both
+typedef struct palette_job_s
+{
+    const palette_t* palette;
+    const uint8_t* rgb;
+    const int* weights;
+    int count;
+    uint8_t* indices;
+    palette_sums_t* sums;
+} palette_job_t;
+
+typedef struct color_box_s
+{
+    int start;
+    int count;
+    int64_t weight;
+    uint8_t low[3];
+    uint8_t high[3];
+} color_box_t;
+
+static void set_palette_size(palette_t* palette, int size)
+{
+    palette->size = size;
+    palette->padded = (size + 3) & ~3;
+    for (int i = size; i < palette->padded; i++)
+    {
+        palette->r[i] = 1e9f;
+        palette->g[i] = 1e9f;
+        palette->b[i] = 1e9f;
+    }
+}
+
+// Nearest entry, the lowest index on ties so both paths agree
+static int nearest_color(const palette_t* palette, const uint8_t* pixel)
+{
+#if defined(__SSE2__)
+    const __m128 r = _mm_set1_ps(pixel[0]);
+    const __m128 g = _mm_set1_ps(pixel[1]);
+    const __m128 b = _mm_set1_ps(pixel[2]);
+    __m128 best = _mm_set1_ps(1e30f);
+    __m128i best_index = _mm_setzero_si128();
+    __m128i index = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i four = _mm_set1_epi32(4);
+
+    for (int i = 0; i < palette->padded; i += 4)
+    {
+        __m128 dr = _mm_sub_ps(_mm_loadu_ps(palette->r + i), r);
+        __m128 dg = _mm_sub_ps(_mm_loadu_ps(palette->g + i), g);
+        __m128 db = _mm_sub_ps(_mm_loadu_ps(palette->b + i), b);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+
+        __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+        best = _mm_min_ps(distance, best);
+        best_index = _mm_or_si128(_mm_and_si128(closer, index), _mm_andnot_si128(closer, best_index));
+        index = _mm_add_epi32(index, four);
+    }
+
+    float distances[4];
+    int32_t indices[4];
+    _mm_storeu_ps(distances, best);
+    _mm_storeu_si128((__m128i*)indices, best_index);
+
+    int nearest = indices[0];
+    float nearest_distance = distances[0];
+    for (int lane = 1; lane < 4; lane++)
+    {
+        if (distances[lane] < nearest_distance || (distances[lane] == nearest_distance && indices[lane] < nearest))
+        {
+            nearest = indices[lane];
+            nearest_distance = distances[lane];
+        }
+    }
+    return nearest;
+#else
+    int nearest = 0;
+    float nearest_distance = 1e30f;
+    for (int i = 0; i < palette->size; i++)
+    {
+        float dr = palette->r[i] - pixel[0];
+        float dg = palette->g[i] - pixel[1];
+        float db = palette->b[i] - pixel[2];
+        float distance = dr * dr + dg * dg + db * db;
+        if (distance < nearest_distance)
+        {
+            nearest = i;
+            nearest_distance = distance;
+        }
+    }
+    return nearest;
+#endif
+}
+
+
+static void* run_palette_job(void* arg)
+{
+    palette_job_t* job = (palette_job_t*)arg;
+
+    for (int i = 0; i < job->count; i++)
+    {
+        const uint8_t* color = job->rgb + 3 * (size_t)i;
+        int nearest = nearest_color(job->palette, color);
+
+        if (job->indices) job->indices[i] = (uint8_t)nearest;
+        if (job->sums)
+        {
+            int weight = job->weights[i];
+            job->sums->r[nearest] += (int64_t)color[0] * weight;
+            job->sums->g[nearest] += (int64_t)color[1] * weight;
+            job->sums->b[nearest] += (int64_t)color[2] * weight;
+            job->sums->count[nearest] += weight;
+        }
+    }
+
+    return NULL;
+}
+
+// Split the colors in contiguous slices over the threads, sums are merged into the first set
+static void run_palette_jobs(const palette_t* palette, const color_set_t* set, uint8_t* indices, palette_sums_t* sums)
+{
+    palette_job_t jobs[PALETTE_THREADS];
+    pthread_t threads[PALETTE_THREADS];
+    int started[PALETTE_THREADS] = { 0 };
+    int count = set->count;
+    int thread_count = count < PALETTE_THREADS ? 1 : PALETTE_THREADS;
+    int slice = (count + thread_count - 1) / thread_count;
+
+    for (int t = 0; t < thread_count; t++)
+    {
+        int first = t * slice < count ? t * slice : count;
+        jobs[t].palette = palette;
+        jobs[t].rgb = set->rgb + 3 * (size_t)first;
+        jobs[t].weights = set->weights + first;
+        jobs[t].count = count - first < slice ? count - first : slice;
+        jobs[t].indices = indices ? indices + first : NULL;
+        jobs[t].sums = sums ? &sums[t] : NULL;
+        if (sums) memset(&sums[t], 0, sizeof(palette_sums_t));
+
+        // a slice whose thread did not start runs here
+        if (t > 0 && !pthread_create(&threads[t], NULL, run_palette_job, &jobs[t])) started[t] = 1;
+    }
+
+    run_palette_job(&jobs[0]);
+    for (int t = 1; t < thread_count; t++)
+    {
+        if (started[t]) pthread_join(threads[t], NULL);
+        else run_palette_job(&jobs[t]);
+    }
+
+    if (!sums) return;
+    for (int t = 1; t < thread_count; t++)
+    {
+        for (int i = 0; i < palette->size; i++)
+        {
+            sums[0].r[i] += sums[t].r[i];
+            sums[0].g[i] += sums[t].g[i];
+            sums[0].b[i] += sums[t].b[i];
+            sums[0].count[i] += sums[t].count[i];
+        }
+    }
+}
+
+static void free_color_set(color_set_t* set)
+{
+    free(set->packed);
+    free(set->rgb);
+    free(set->weights);
+}
+
+// Sort the packed colors, one counting pass per channel, and merge the duplicates
+static int collect_colors(uint32_t* packed, int count, color_set_t* set)
+{
+    uint32_t* scratch = (uint32_t*)malloc((size_t)count * sizeof(uint32_t));
+    if (!scratch) return PG_ALLOCATION_ERROR;
+
+    uint32_t* keys = packed;
+    uint32_t* sorted = scratch;
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        int offsets[256] = { 0 };
+        for (int i = 0; i < count; i++) offsets[(keys[i] >> shift) & 255]++;
+        for (int bucket = 0, total = 0; bucket < 256; bucket++)
+        {
+            int size = offsets[bucket];
+            offsets[bucket] = total;
+            total += size;
+        }
+        for (int i = 0; i < count; i++) sorted[offsets[(keys[i] >> shift) & 255]++] = keys[i];
+
+        uint32_t* swap = keys;
+        keys = sorted;
+        sorted = swap;
+    }
+    // after three passes the keys sit in the scratch buffer
+    memcpy(packed, keys, (size_t)count * sizeof(uint32_t));
+    free(scratch);
+
+    int distinct = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!i || packed[i] != packed[i - 1]) distinct++;
+    }
+
+    set->count = distinct;
+    set->packed = (uint32_t*)malloc((size_t)distinct * sizeof(uint32_t));
+    set->rgb = (uint8_t*)malloc(3 * (size_t)distinct);
+    set->weights = (int*)malloc((size_t)distinct * sizeof(int));
+    if (!set->packed || !set->rgb || !set->weights) return PG_ALLOCATION_ERROR;
+
+    for (int i = 0, d = -1; i < count; i++)
+    {
+        if (i && packed[i] == packed[i - 1])
+        {
+            set->weights[d]++;
+            continue;
+        }
+
+        d++;
+        set->packed[d] = packed[i];
+        set->rgb[3 * (size_t)d] = (uint8_t)(packed[i] >> 16);
+        set->rgb[3 * (size_t)d + 1] = (uint8_t)(packed[i] >> 8);
+        set->rgb[3 * (size_t)d + 2] = (uint8_t)packed[i];
+        set->weights[d] = 1;
+    }
+
+    return PG_SUCCESS;
+}
+
+// Distinct colors of the whole image, or of picks random pixels when picks is positive
+static int collect_image_colors(const uint8_t* pixels, int count, int picks, color_set_t* set)
+{
+    int last_status = PG_SUCCESS;
+    int packed_count = picks > 0 ? picks : count;
+    uint32_t random_state = PALETTE_SEED;
+
+    uint32_t* packed = (uint32_t*)malloc((size_t)packed_count * sizeof(uint32_t));
+    if (!packed) return PG_ALLOCATION_ERROR;
+
+    for (int i = 0; i < packed_count; i++)
+    {
+        int pixel = picks > 0 ? (int)(random_float(&random_state) * count) : i;
+        const uint8_t* color = pixels + 3 * (size_t)pixel;
+        packed[i] = (uint32_t)color[0] << 16 | (uint32_t)color[1] << 8 | color[2];
+    }
+
+    last_status = collect_colors(packed, packed_count, set);
+    if (last_status) free_color_set(set);
+    free(packed);
+
+    return last_status;
+}
+
+static void fit_box(color_box_t* box, const color_set_t* set)
+{
+    box->weight = 0;
+    for (int c = 0; c < 3; c++)
+    {
+        box->low[c] = 255;
+        box->high[c] = 0;
+    }
+
+    for (int i = box->start; i < box->start + box->count; i++)
+    {
+        box->weight += set->weights[i];
+        for (int c = 0; c < 3; c++)
+        {
+            uint8_t value = set->rgb[3 * (size_t)i + c];
+            if (value < box->low[c]) box->low[c] = value;
+            if (value > box->high[c]) box->high[c] = value;
+        }
+    }
+}
+
+static int widest_axis(const color_box_t* box)
+{
+    int axis = 0;
+    for (int c = 1; c < 3; c++)
+    {
+        if (box->high[c] - box->low[c] > box->high[axis] - box->low[axis]) axis = c;
+    }
+    return axis;
+}
+
+// Cut the box at the pixel median of its widest axis, found from a histogram of that channel.
+// The cut stays below the highest value so both halves keep some colors.
+static void split_box(color_box_t* box, color_box_t* upper, color_set_t* set)
+{
+    int axis = widest_axis(box);
+    int64_t histogram[256] = { 0 };
+    for (int i = box->start; i < box->start + box->count; i++)
+    {
+        histogram[set->rgb[3 * (size_t)i + axis]] += set->weights[i];
+    }
+
+    int cut = box->low[axis];
+    for (int64_t below = histogram[cut]; 2 * below < box->weight && cut < box->high[axis] - 1; below += histogram[cut])
+    {
+        cut++;
+    }
+
+    int left = box->start;
+    int right = box->start + box->count - 1;
+    while (left <= right)
+    {
+        if (set->rgb[3 * (size_t)left + axis] <= cut)
+        {
+            left++;
+            continue;
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            uint8_t swap = set->rgb[3 * (size_t)left + c];
+            set->rgb[3 * (size_t)left + c] = set->rgb[3 * (size_t)right + c];
+            set->rgb[3 * (size_t)right + c] = swap;
+        }
+        int swap = set->weights[left];
+        set->weights[left] = set->weights[right];
+        set->weights[right] = swap;
+        right--;
+    }
+
+    upper->start = left;
+    upper->count = box->start + box->count - left;
+    box->count = left - box->start;
+    fit_box(box, set);
+    fit_box(upper, set);
+}
+
+// Median cut, the widest box is split until there are enough boxes.
+// Reorders the colors of the set, its packed keys no longer match them.
+static void median_cut(color_set_t* set, int colors, palette_t* palette)
+{
+    color_box_t boxes[PALETTE_MAX_COLORS];
+    int box_count = 1;
+    boxes[0].start = 0;
+    boxes[0].count = set->count;
+    fit_box(&boxes[0], set);
+
+    while (box_count < colors)
+    {
+        int widest = -1;
+        int widest_range = 0;
+        for (int i = 0; i < box_count; i++)
+        {
+            int axis = widest_axis(&boxes[i]);
+            int range = boxes[i].high[axis] - boxes[i].low[axis];
+            if (range > widest_range)
+            {
+                widest = i;
+                widest_range = range;
+            }
+        }
+        if (widest < 0) break;
+
+        split_box(&boxes[widest], &boxes[box_count], set);
+        box_count++;
+    }
+
+    set_palette_size(palette, box_count);
+    for (int i = 0; i < box_count; i++)
+    {
+        int64_t sum[3] = { 0, 0, 0 };
+        for (int p = boxes[i].start; p < boxes[i].start + boxes[i].count; p++)
+        {
+            for (int c = 0; c < 3; c++) sum[c] += (int64_t)set->rgb[3 * (size_t)p + c] * set->weights[p];
+        }
+        palette->r[i] = (float)sum[0] / boxes[i].weight;
+        palette->g[i] = (float)sum[1] / boxes[i].weight;
+        palette->b[i] = (float)sum[2] / boxes[i].weight;
+    }
+}
+
+// Lloyd iterations, every entry moves to the mean of the pixels nearest to it.
+// Entries nobody is nearest to stay where they are.
+static int refine_palette(const color_set_t* set, palette_t* palette, int max_iterations, int* p_iterations)
+{
+    palette_sums_t* sums = (palette_sums_t*)malloc(PALETTE_THREADS * sizeof(palette_sums_t));
+    if (!sums) return PG_ALLOCATION_ERROR;
+
+    int iteration = 0;
+    while (iteration < max_iterations)
+    {
+        run_palette_jobs(palette, set, NULL, sums);
+        iteration++;
+
+        float moved = 0.0f;
+        for (int i = 0; i < palette->size; i++)
+        {
+            if (!sums[0].count[i]) continue;
+
+            float r = (float)sums[0].r[i] / sums[0].count[i];
+            float g = (float)sums[0].g[i] / sums[0].count[i];
+            float b = (float)sums[0].b[i] / sums[0].count[i];
+            float distance = fabsf(r - palette->r[i]) + fabsf(g - palette->g[i]) + fabsf(b - palette->b[i]);
+            if (distance > moved) moved = distance;
+
+            palette->r[i] = r;
+            palette->g[i] = g;
+            palette->b[i] = b;
+        }
+
+        if (moved < PALETTE_TOLERANCE) break;
+    }
+
+    free(sums);
+    *p_iterations = iteration;
+    return PG_SUCCESS;
+}
+
+static int find_color(const color_set_t* set, uint32_t packed)
+{
+    int low = 0;
+    int high = set->count - 1;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (set->packed[middle] < packed) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// Reduce an RGB image to at most colors entries, written to palette as RGB triplets,
+// and the index of every pixel. Images with few enough colors keep them exactly.
+// Otherwise the palette starts from a median cut and is refined by up to max_iterations
+// of k-means over the distinct colors of the image, or of that many random pixels when
+// samples is positive.
+int fit_palette(const uint8_t* pixels, int count, int colors, int samples, int max_iterations,
+    uint8_t* output_palette, int* output_size, uint8_t* indices)
+{
+    int last_status = PG_SUCCESS;
+
+    if (count < 1 || colors < 2 || colors > PALETTE_MAX_COLORS || max_iterations < 0) return PG_INVALID_PARAMETER;
+
+    palette_t palette = { 0 };
+    color_set_t image = { 0 };
+    color_set_t fitted = { 0 };
+    uint8_t* nearest = NULL;
+    int iterations = 0;
+    int picks = samples > 0 && samples < count ? samples : 0;
+
+    CHECK_CALL(collect_image_colors, pixels, count, 0, &image);
+
+    if (image.count <= colors)
+    {
+        set_palette_size(&palette, image.count);
+        for (int i = 0; i < image.count; i++)
+        {
+            palette.r[i] = image.rgb[3 * (size_t)i];
+            palette.g[i] = image.rgb[3 * (size_t)i + 1];
+            palette.b[i] = image.rgb[3 * (size_t)i + 2];
+        }
+    }
+    else
+    {
+        // the median cut reorders the colors it works on, the image set stays sorted
+        if (picks)
+        {
+            CHECK_CALL_GOTO_ERROR(collect_image_colors, cleanup, pixels, count, picks, &fitted);
+        }
+        else
+        {
+            fitted.count = image.count;
+            fitted.rgb = (uint8_t*)malloc(3 * (size_t)image.count);
+            fitted.weights = (int*)malloc((size_t)image.count * sizeof(int));
+            if (!fitted.rgb || !fitted.weights)
+            {
+                last_status = PG_ALLOCATION_ERROR;
+                goto cleanup;
+            }
+            memcpy(fitted.rgb, image.rgb, 3 * (size_t)image.count);
+            memcpy(fitted.weights, image.weights, (size_t)image.count * sizeof(int));
+        }
+
+        median_cut(&fitted, colors, &palette);
+        CHECK_CALL_GOTO_ERROR(refine_palette, cleanup, &fitted, &palette, max_iterations, &iterations);
+    }
+
+    // colors are mapped to the palette as it is written, rounding included
+    for (int i = 0; i < palette.size; i++)
+    {
+        output_palette[3 * i] = (uint8_t)(palette.r[i] + 0.5f);
+        output_palette[3 * i + 1] = (uint8_t)(palette.g[i] + 0.5f);
+        output_palette[3 * i + 2] = (uint8_t)(palette.b[i] + 0.5f);
+        palette.r[i] = output_palette[3 * i];
+        palette.g[i] = output_palette[3 * i + 1];
+        palette.b[i] = output_palette[3 * i + 2];
+    }
+
+    nearest = (uint8_t*)malloc((size_t)image.count);
+    if (!nearest)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+    run_palette_jobs(&palette, &image, nearest, NULL);
+
+    for (int i = 0; i < count; i++)
+    {
+        const uint8_t* color = pixels + 3 * (size_t)i;
+        uint32_t packed = (uint32_t)color[0] << 16 | (uint32_t)color[1] << 8 | color[2];
+        indices[i] = nearest[find_color(&image, packed)];
+    }
+    *output_size = palette.size;
+
+    if (image.count > colors)
+    {
+        printf("[>] Palette: %d colors fitted on %d distinct colors in %d k-means iterations\n", palette.size,
+            picks ? fitted.count : image.count, iterations);
+    }
+    else
+    {
+        printf("[>] Palette: the %d colors of the image are kept as they are\n", palette.size);
+    }
+
+cleanup:
+    free(nearest);
+    free_color_set(&image);
+    free_color_set(&fitted);
+
+    return last_status;
+}
+
+int quantize_palette(const uint8_t* pixels, int count, int colors, int samples,
+    uint8_t* output_palette, int* output_size, uint8_t* indices)
+{
+    return fit_palette(pixels, count, colors, samples, PALETTE_ITERATIONS, output_palette, output_size, indices);
+}
@@ -0,0 +1,216 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/png_stream.h"
+
+#define PNG_HEADER_SIZE 29      // signature and IHDR chunk up to the interlace method
+
+// Rows decoded by libpng as the file is read, written straight into a
+// mapped pixel unpack buffer. Bands of rows are uploaded as soon as they
+// are complete, the GPU copies one while the next one decodes.
+typedef struct png_stream_s
+{
+    png_structp png;
+    png_infop info;
+    GLuint texture;
+    GLuint buffers[PNG_STREAM_BUFFERS];
+    int buffer;                 // being filled
+    uint8_t* mapped;
+    int width;
+    int height;
+    GLenum format;
+    size_t stride;
+    int band_rows;
+    int band_start;             // first image row of the band, top first
+    int done;
+} png_stream_t;
+
+// Only non interlaced PNGs are streamed, the rows of an interlaced one are
+// rewritten by every pass and would be read back from the buffer
+int can_stream_png(const char* path)
+{
+    uint8_t header[PNG_HEADER_SIZE];
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+
+    int complete = fread(header, sizeof(header), 1, file) == 1;
+    fclose(file);
+
+    return complete && !png_sig_cmp(header, 0, 8) && !memcmp(header + 12, "IHDR", 4) && header[28] == PNG_INTERLACE_NONE;
+}
+
+static void map_band(png_stream_t* stream)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[stream->buffer]);
+
+    // invalidated, the upload still reading the previous band never stalls the map
+    stream->mapped = (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)stream->stride * stream->band_rows,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!stream->mapped) png_error(stream->png, "cannot map the pixel unpack buffer");
+}
+
+// The rows of the band were written bottom up, the texture is filled in the
+// OpenGL orientation without a flip pass
+static void upload_band(png_stream_t* stream)
+{
+    int end = stream->band_start + stream->band_rows;
+    if (end > stream->height) end = stream->height;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[stream->buffer]);
+    stream->mapped = NULL;
+    if (!glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) png_error(stream->png, "pixel unpack buffer lost while mapped");
+
+    glBindTexture(GL_TEXTURE_2D, stream->texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, stream->height - end, stream->width, end - stream->band_start,
+        stream->format, GL_UNSIGNED_BYTE, 0);
+
+    stream->band_start = end;
+    stream->buffer = (stream->buffer + 1) % PNG_STREAM_BUFFERS;
+    if (end < stream->height) map_band(stream);
+}
+
+static void PNGCBAPI stream_info(png_structp png, png_infop info)
+{
+    png_stream_t* stream = (png_stream_t*)png_get_progressive_ptr(png);
+
+    // same channels as stbi_load, 8 bits each
+    png_set_expand(png);
+    png_set_strip_16(png);
+    png_read_update_info(png, info);
+
+    int channels = png_get_channels(png, info);
+    stream->width = (int)png_get_image_width(png, info);
+    stream->height = (int)png_get_image_height(png, info);
+    stream->stride = png_get_rowbytes(png, info);
+    stream->format = channels == 4 ? GL_RGBA : channels == 3 ? GL_RGB : channels == 2 ? GL_RG : GL_RED;
+    stream->band_rows = (int)(PNG_STREAM_BAND / stream->stride);
+    if (stream->band_rows < 1) stream->band_rows = 1;
+    if (stream->band_rows > stream->height) stream->band_rows = stream->height;
+
+    glGenTextures(1, &stream->texture);
+    glBindTexture(GL_TEXTURE_2D, stream->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, stream->format, stream->width, stream->height, 0, stream->format, GL_UNSIGNED_BYTE, NULL);
+    if (glGetError() != GL_NO_ERROR) png_error(png, "cannot allocate the texture");
+
+    glGenBuffers(PNG_STREAM_BUFFERS, stream->buffers);
+    for (int b = 0; b < PNG_STREAM_BUFFERS; b++)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[b]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)stream->stride * stream->band_rows, NULL, GL_STREAM_DRAW);
+    }
+    map_band(stream);
+}
+
+static void PNGCBAPI stream_row(png_structp png, png_bytep row, png_uint_32 y, int pass)
+{
+    (void)pass;
+    png_stream_t* stream = (png_stream_t*)png_get_progressive_ptr(png);
+    if (!row) return;
+
+    int end = stream->band_start + stream->band_rows;
+    if (end > stream->height) end = stream->height;
+
+    memcpy(stream->mapped + (size_t)(end - 1 - (int)y) * stream->stride, row, stream->stride);
+    if ((int)y == end - 1) upload_band(stream);
+}
+
+static void PNGCBAPI stream_end(png_structp png, png_infop info)
+{
+    (void)info;
+    png_stream_t* stream = (png_stream_t*)png_get_progressive_ptr(png);
+    stream->done = 1;
+}
+
+// Feed the file to libpng chunk after chunk, its errors jump back here. Nothing but
+// the stream changes between setjmp and longjmp, no local can be clobbered.
+static int feed_stream(png_stream_t* stream, FILE* file, uint8_t* chunk)
+{
+    if (setjmp(png_jmpbuf(stream->png))) return PG_UNREADABLE_FILE;
+
+    png_set_progressive_read_fn(stream->png, stream, stream_info, stream_row, stream_end);
+
+    size_t length;
+    while (!stream->done && (length = fread(chunk, 1, PNG_STREAM_CHUNK, file)) > 0)
+    {
+        png_process_data(stream->png, stream->info, chunk, length);
+    }
+
+    return PG_SUCCESS;
+}
+
+// Decodes a non interlaced PNG into a texture, in the OpenGL orientation like
+// load_image, without holding the image in memory. image gets its size and
+// format, its buffer stays NULL.
+int stream_png_texture(const char* path, image_t* image, GLuint* p_texture)
+{
+    int last_status = PG_SUCCESS;
+    uint8_t* chunk = NULL;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return PG_NOT_FOUND;
+
+    png_stream_t* stream = (png_stream_t*)calloc(1, sizeof(png_stream_t));
+    chunk = (uint8_t*)malloc(PNG_STREAM_CHUNK);
+    if (!stream || !chunk)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    stream->png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    stream->info = stream->png ? png_create_info_struct(stream->png) : NULL;
+    if (!stream->info)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    double start = glfwGetTime();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    CHECK_CALL_GOTO_ERROR(feed_stream, cleanup, stream, file, chunk);
+
+    if (!stream->done || stream->band_start != stream->height)
+    {
+        fprintf(stderr, "Truncated PNG: %s\n", path);
+        last_status = PG_UNREADABLE_FILE;
+        goto cleanup;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, stream->texture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    printf("[>] Image streamed to the GPU in %.3f s: %dx%d with %d channels\n",
+        glfwGetTime() - start, stream->width, stream->height, png_get_channels(stream->png, stream->info));
+
+    image->buf = NULL;
+    image->width = stream->width;
+    image->height = stream->height;
+    image->format = stream->format;
+    *p_texture = stream->texture;
+    stream->texture = 0;
+
+cleanup:
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (stream)
+    {
+        if (stream->mapped)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[stream->buffer]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (stream->buffers[0]) glDeleteBuffers(PNG_STREAM_BUFFERS, stream->buffers);
+        if (stream->texture) glDeleteTextures(1, &stream->texture);
+        png_destroy_read_struct(&stream->png, &stream->info, NULL);
+        free(stream);
+    }
+    free(chunk);
+    fclose(file);
+    return last_status;
+}
@@ -0,0 +1,370 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/poisson.h"
+
+// Bridson's background grid, cells are small enough to hold a single point.
+// The domain is cut in tiles filled in four phases, tiles of a phase are a tile apart
+// and only touch their own cells, so they can be filled in parallel.
+typedef struct sampler_s
+{
+    const image_t* density;
+    float min_radius;
+    float max_radius;
+    float domain;
+    float cell;
+    int cells;
+    float* grid;                // position.xy radius per cell, radius 0 when empty
+    int tile_cells;
+    int tiles;
+} sampler_t;
+
+typedef struct tile_job_s
+{
+    sampler_t* sampler;
+    int phase;
+    int thread;
+    int thread_count;
+    int status;
+} tile_job_t;
+
+// Darker pixels of the density image pack the points closer
+static float radius_at(const sampler_t* sampler, float x, float y)
+{
+    const image_t* image = sampler->density;
+    if (!image) return sampler->min_radius;
+
+    int px = (int)((x / sampler->domain + 0.5f) * image->width);
+    int py = (int)((y / sampler->domain + 0.5f) * image->height);
+    if (px < 0) px = 0;
+    if (py < 0) py = 0;
+    if (px > image->width - 1) px = image->width - 1;
+    if (py > image->height - 1) py = image->height - 1;
+
+    int channels = image->format == GL_RGBA ? 4 : image->format == GL_RGB ? 3 : image->format == GL_RG ? 2 : 1;
+    const unsigned char* texel = image->buf + ((size_t)py * image->width + px) * channels;
+    float luminance = channels < 3 ? texel[0] / 255.0f :
+        (0.2126f * texel[0] + 0.7152f * texel[1] + 0.0722f * texel[2]) / 255.0f;
+
+    return sampler->min_radius + (sampler->max_radius - sampler->min_radius) * luminance;
+}
+
+static int cell_of(const sampler_t* sampler, float v)
+{
+    return (int)((v + 0.5f * sampler->domain) / sampler->cell);
+}
+
+// Accept a point when no other is closer than the largest of their radii
+static int is_valid(const sampler_t* sampler, float x, float y, float r)
+{
+    int cx = cell_of(sampler, x);
+    int cy = cell_of(sampler, y);
+    int reach = (int)ceilf(fmaxf(r, sampler->max_radius) / sampler->cell);
+    if (cx < 0 || cy < 0 || cx >= sampler->cells || cy >= sampler->cells) return 0;
+
+    for (int j = cy - reach; j <= cy + reach; j++)
+    {
+        if (j < 0 || j >= sampler->cells) continue;
+        for (int i = cx - reach; i <= cx + reach; i++)
+        {
+            if (i < 0 || i >= sampler->cells) continue;
+            const float* q = sampler->grid + 3 * ((size_t)j * sampler->cells + i);
+            if (q[2] == 0.0f) continue;
+
+            float dx = q[0] - x;
+            float dy = q[1] - y;
+            float d = fmaxf(r, q[2]);
+            if (dx * dx + dy * dy < d * d) return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int push_active(float** active, int* count, int* capacity, const float* point)
+{
+    if (*count == *capacity)
+    {
+        int grown = *capacity ? 2 * *capacity : 256;
+        float* resized = (float*)realloc(*active, (size_t)grown * 3 * sizeof(float));
+        if (!resized) return PG_ALLOCATION_ERROR;
+        *active = resized;
+        *capacity = grown;
+    }
+
+    memcpy(*active + 3 * (*count)++, point, 3 * sizeof(float));
+    return PG_SUCCESS;
+}
+
+static int insert_point(sampler_t* sampler, float** active, int* count, int* capacity, float x, float y, float r)
+{
+    float* cell = sampler->grid + 3 * ((size_t)cell_of(sampler, y) * sampler->cells + cell_of(sampler, x));
+    cell[0] = x;
+    cell[1] = y;
+    cell[2] = r;
+    return push_active(active, count, capacity, cell);
+}
+
+// Bridson's algorithm restricted to one tile. Points already placed around the tile
+// start active too, so the tile grows from its borders as well as from its seeds.
+static int fill_tile(sampler_t* sampler, int tx, int ty)
+{
+    int last_status = PG_SUCCESS;
+    uint32_t seed = POISSON_SEED ^ (uint32_t)(ty * sampler->tiles + tx + 1) * 2654435761u;
+    if (!seed) seed = POISSON_SEED;
+
+    int first[2] = { tx * sampler->tile_cells, ty * sampler->tile_cells };
+    int last[2] = { first[0] + sampler->tile_cells, first[1] + sampler->tile_cells };
+    if (last[0] > sampler->cells) last[0] = sampler->cells;
+    if (last[1] > sampler->cells) last[1] = sampler->cells;
+    float low[2] = { first[0] * sampler->cell - 0.5f * sampler->domain, first[1] * sampler->cell - 0.5f * sampler->domain };
+    float high[2] = { last[0] * sampler->cell - 0.5f * sampler->domain, last[1] * sampler->cell - 0.5f * sampler->domain };
+
+    float* active = NULL;
+    int count = 0;
+    int capacity = 0;
+
+    int border = (int)ceilf(2.0f * sampler->max_radius / sampler->cell);
+    for (int j = first[1] - border; j < last[1] + border && !last_status; j++)
+    {
+        if (j < 0 || j >= sampler->cells) continue;
+        for (int i = first[0] - border; i < last[0] + border && !last_status; i++)
+        {
+            if (i < 0 || i >= sampler->cells) continue;
+            const float* q = sampler->grid + 3 * ((size_t)j * sampler->cells + i);
+            if (q[2] != 0.0f) last_status = push_active(&active, &count, &capacity, q);
+        }
+    }
+
+    for (int s = 0; s < POISSON_SEEDS && !last_status; s++)
+    {
+        float x = low[0] + (high[0] - low[0]) * random_float(&seed);
+        float y = low[1] + (high[1] - low[1]) * random_float(&seed);
+        float r = radius_at(sampler, x, y);
+        if (is_valid(sampler, x, y, r)) last_status = insert_point(sampler, &active, &count, &capacity, x, y, r);
+    }
+
+    while (count && !last_status)
+    {
+        int k = (int)(random_float(&seed) * count);
+        float px = active[3 * k];
+        float py = active[3 * k + 1];
+        float pr = active[3 * k + 2];
+        int found = 0;
+
+        for (int c = 0; c < POISSON_CANDIDATES; c++)
+        {
+            float angle = 2.0f * (float)M_PI * random_float(&seed);
+            float distance = pr * (1.0f + random_float(&seed));
+            float x = px + cosf(angle) * distance;
+            float y = py + sinf(angle) * distance;
+            if (x < low[0] || y < low[1] || x >= high[0] || y >= high[1]) continue;
+
+            float r = radius_at(sampler, x, y);
+            if (!is_valid(sampler, x, y, r)) continue;
+
+            last_status = insert_point(sampler, &active, &count, &capacity, x, y, r);
+            found = 1;
+            break;
+        }
+
+        // nothing fits around this point anymore
+        if (!found)
+        {
+            memcpy(active + 3 * k, active + 3 * (count - 1), 3 * sizeof(float));
+            count--;
+        }
+    }
+
+    free(active);
+    return last_status;
+}
+
+static void* fill_phase(void* arg)
+{
+    tile_job_t* job = (tile_job_t*)arg;
+    sampler_t* sampler = job->sampler;
+    int n = 0;
+
+    for (int ty = job->phase >> 1; ty < sampler->tiles; ty += 2)
+    {
+        for (int tx = job->phase & 1; tx < sampler->tiles; tx += 2)
+        {
+            if (n++ % job->thread_count != job->thread) continue;
+            job->status = fill_tile(sampler, tx, ty);
+            if (job->status) return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+static int sample(sampler_t* sampler, int thread_count)
+{
+    int last_status = PG_SUCCESS;
+
+    for (int phase = 0; phase < 4; phase++)
+    {
+        pthread_t threads[POISSON_THREADS];
+        tile_job_t jobs[POISSON_THREADS];
+        int started = 0;
+
+        for (int t = 0; t < thread_count; t++)
+        {
+            jobs[t].sampler = sampler;
+            jobs[t].phase = phase;
+            jobs[t].thread = t;
+            jobs[t].thread_count = thread_count;
+            jobs[t].status = PG_SUCCESS;
+            if (pthread_create(&threads[t], NULL, fill_phase, &jobs[t]))
+            {
+                last_status = PG_EXTERNAL_ERROR;
+                break;
+            }
+            started++;
+        }
+
+        for (int t = 0; t < started; t++)
+        {
+            pthread_join(threads[t], NULL);
+            if (jobs[t].status) last_status = jobs[t].status;
+        }
+        if (last_status) return last_status;
+    }
+
+    return last_status;
+}
+
+// Points as position.xy radius, compacted from the grid. Tiles of a phase are shared
+// between the threads, the points do not depend on how many there are.
+int sample_poisson(float radius, float domain, const image_t* density, int tiled, int thread_count, float** points, int* count)
+{
+    int last_status = PG_SUCCESS;
+
+    if (radius <= 0.0f || domain <= 0.0f || thread_count < 1 || thread_count > POISSON_THREADS) return PG_INVALID_PARAMETER;
+
+    sampler_t sampler = { 0 };
+    sampler.density = density;
+    sampler.min_radius = radius;
+    sampler.max_radius = density ? radius * POISSON_RADIUS_RATIO : radius;
+    sampler.domain = domain;
+    sampler.cell = radius / sqrtf(2.0f);
+    sampler.cells = (int)ceilf(domain / sampler.cell);
+
+    // a tile must be wider than what a fill reads around it, the neighbors of two tiles
+    // of a phase are then distinct. Without tiling a single tile covers the domain.
+    int border = (int)ceilf(2.0f * sampler.max_radius / sampler.cell) + 1;
+    sampler.tile_cells = tiled ? (POISSON_TILE_CELLS > border ? POISSON_TILE_CELLS : border) : sampler.cells;
+    sampler.tiles = (sampler.cells + sampler.tile_cells - 1) / sampler.tile_cells;
+
+    sampler.grid = (float*)calloc((size_t)sampler.cells * sampler.cells * 3, sizeof(float));
+    if (!sampler.grid) return PG_ALLOCATION_ERROR;
+
+    last_status = sample(&sampler, tiled ? thread_count : 1);
+    if (last_status)
+    {
+        free(sampler.grid);
+        return last_status;
+    }
+
+    // compact the grid into the point buffer
+    size_t cell_count = (size_t)sampler.cells * sampler.cells;
+    int compacted = 0;
+    for (size_t c = 0; c < cell_count; c++)
+    {
+        if (sampler.grid[3 * c + 2] == 0.0f) continue;
+        memmove(sampler.grid + 3 * (size_t)compacted++, sampler.grid + 3 * c, 3 * sizeof(float));
+    }
+
+    *points = sampler.grid;
+    *count = compacted;
+    return last_status;
+}
+
+int init_poisson(poisson_t* poisson, const char* density_path, state_t* state)
+{
+    int last_status = PG_SUCCESS;
+
+    if (poisson->radius <= 0.0f) poisson->radius = POISSON_DEFAULT_RADIUS;
+    if (poisson->domain <= 0.0f) poisson->domain = POISSON_DEFAULT_DOMAIN;
+
+    image_t density = { 0 };
+    if (density_path)
+    {
+        CHECK_CALL(load_image, density_path, &density, NULL);
+    }
+
+    float* points = NULL;
+    int count = 0;
+    double start = glfwGetTime();
+    last_status = sample_poisson(poisson->radius, poisson->domain, density_path ? &density : NULL,
+        poisson->tiled, POISSON_THREADS, &points, &count);
+    if (density.buf) stbi_image_free(density.buf);
+    if (last_status) return last_status;
+    poisson->point_count = count;
+
+    printf("[>] Poisson disk: %d points in %.2f s%s\n", count, glfwGetTime() - start, poisson->tiled ? ", tiled" : "");
+
+    float corners[] =
+    {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+        -1.0f,  1.0f,
+         1.0f,  1.0f
+    };
+
+    glGenVertexArrays(1, &poisson->vao);
+    glGenBuffers(1, &poisson->quad);
+    glGenBuffers(1, &poisson->buffer);
+    glBindVertexArray(poisson->vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, poisson->quad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, poisson->buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(count ? count : 1) * 3 * sizeof(float), points, GL_STATIC_DRAW);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    free(points);
+
+    // the whole domain in view
+    state->zoom = 4.0f / poisson->domain;
+    state->offset[0] = 0.0f;
+    state->offset[1] = 0.0f;
+
+    return last_status;
+}
+
+void draw_poisson(poisson_t* poisson, GLuint program, const state_t* state, int width, int height)
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)width, (float)height);
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], state->offset[1]);
+    glUniform1f(glGetUniformLocation(program, "zoom"), state->zoom);
+    glUniform1f(glGetUniformLocation(program, "dot_scale"), POISSON_DOT_SCALE);
+    glUniform3f(glGetUniformLocation(program, "color2"), 0.5, 1.0, 0.7);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(poisson->vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, poisson->point_count);
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
+
+void free_poisson(poisson_t* poisson)
+{
+    if (poisson->buffer) glDeleteBuffers(1, &poisson->buffer);
+    if (poisson->quad) glDeleteBuffers(1, &poisson->quad);
+    if (poisson->vao) glDeleteVertexArrays(1, &poisson->vao);
+}
@@ -0,0 +1,137 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/postprocessing.h"
+#include "../include/render_graph.h"
+#include "../include/shaders.h"
+#include "../include/blue_noise.h"
+#include "../include/color_lut.h"
+#include "../include/edge_detection.h"
+
+int init_postprocessing(postprocessing_t* postprocessing)
+{
+    int last_status = PG_SUCCESS;
+
+    // keep the values given on the command line
+    if (postprocessing->dithering_pattern < 0) postprocessing->dithering_pattern = POSTPROCESSING_DITHERING_PATTERN;
+    postprocessing->dithering_strength = POSTPROCESSING_DITHERING_STRENGTH;
+    postprocessing->quantization_method = POSTPROCESSING_QUANTIZATION_METHOD;
+    if (postprocessing->quantization_levels < 2) postprocessing->quantization_levels = POSTPROCESSING_QUANTIZATION_LEVELS;
+    CHECK_CALL(create_program, "shaders/vertex_pass.glsl", "shaders/fragment_postprocessing.frag", &postprocessing->program);
+    CHECK_CALL(init_color_lut, &postprocessing->lut, COLOR_LUT_SIZE);
+    CHECK_CALL(init_edge_detection, &postprocessing->edges);
+    if (postprocessing->dithering_pattern == 1)
+    {
+        CHECK_CALL(load_blue_noise, BLUE_NOISE_SIZE, &postprocessing->blue_noise);
+    }
+
+    return last_status;
+}
+
+// Rebake the color LUT when the quantization changed, outside of any pass
+int prepare_postprocessing(postprocessing_t* postprocessing)
+{
+    int last_status = PG_SUCCESS;
+
+    // exports are diffused on the CPU, the window shows the source untouched
+    int diffused = postprocessing->diffusion_kernel != DIFFUSION_NONE;
+    int method = diffused ? -1 : postprocessing->quantization_method;
+    CHECK_CALL(update_color_lut, &postprocessing->lut, method, postprocessing->quantization_levels);
+
+    return last_status;
+}
+
+// Setup of the post-processing pass, the image mode calls it on its own program
+void set_postprocessing_uniforms(GLuint program, const void* user)
+{
+    const postprocessing_t* postprocessing = (const postprocessing_t*)user;
+    int diffused = postprocessing->diffusion_kernel != DIFFUSION_NONE;
+
+    glUniform1i(glGetUniformLocation(program, "dithering_pattern"), postprocessing->dithering_pattern);
+    glUniform1f(glGetUniformLocation(program, "dithering_strength"), diffused ? 0.0f : postprocessing->dithering_strength);
+    glUniform2f(glGetUniformLocation(program, "pixel_offset"), 
+        (float)postprocessing->pixel_offset[0], (float)postprocessing->pixel_offset[1]);
+    bind_color_lut(&postprocessing->lut, program);
+
+    // after the inputs of any render graph pass
+    if (postprocessing->dithering_pattern == 1)
+    {
+        glUniform1i(glGetUniformLocation(program, "blue_noise_texture"), RENDER_GRAPH_MAX_INPUTS);
+        glActiveTexture(GL_TEXTURE0 + RENDER_GRAPH_MAX_INPUTS);
+        glBindTexture(GL_TEXTURE_2D, postprocessing->blue_noise);
+        glActiveTexture(GL_TEXTURE0);
+    }
+}
+
+// Quantization and dithering pass of the source resource, faded across its edge map
+int add_postprocessing_pass(postprocessing_t* postprocessing, render_graph_t* graph, 
+    int source, int edges, int width, int height, int* output)
+{
+    render_pass_t dither = { 0 };
+    dither.program = postprocessing->program;
+    dither.input_count = 2;
+    dither.inputs[0] = source;
+    dither.samplers[0] = "source_texture";
+    dither.inputs[1] = edges;
+    dither.samplers[1] = "edge_texture";
+    dither.width = width;
+    dither.height = height;
+    dither.setup = set_postprocessing_uniforms;
+    dither.user = postprocessing;
+
+    return add_render_pass(graph, &dither, output);
+}
+
+// Quantize and dither the offscreen output of a generator, in place of the texture.
+// The frame is upscaled first so the patterns stay one window pixel wide.
+// Everything is declared every frame, the passes are culled while post-processing is off.
+int run_postprocessing(postprocessing_t* postprocessing, render_graph_t* graph, const dynres_t* dynres, 
+    const state_t* state, int render_width, int render_height, GLuint vao, GLuint* texture)
+{
+    int last_status = PG_SUCCESS;
+    int scene = 0;
+    int source = 0;
+    int edges = 0;
+    int processed = 0;
+    GLuint edge_texture = 0;
+
+    // the edge map is read at render resolution, before the upscale,
+    // the compute variant cannot be a pass of the graph and is imported
+    if (state->postprocess)
+    {
+        CHECK_CALL(prepare_postprocessing, postprocessing);
+        CHECK_CALL(detect_edges, &postprocessing->edges, *texture, render_width, render_height, &edge_texture);
+    }
+
+    begin_render_graph(graph);
+    CHECK_CALL(import_render_texture, graph, *texture, &scene);
+    CHECK_CALL(import_render_texture, graph, edge_texture, &edges);
+    source = scene;
+
+    if (render_width != state->width || render_height != state->height)
+    {
+        render_pass_t upscale = { 0 };
+        upscale.program = dynres->upscale_program;
+        upscale.input_count = 1;
+        upscale.inputs[0] = scene;
+        upscale.samplers[0] = "source_texture";
+        upscale.width = state->width;
+        upscale.height = state->height;
+        CHECK_CALL(add_render_pass, graph, &upscale, &source);
+    }
+
+    CHECK_CALL(add_postprocessing_pass, postprocessing, graph, source, edges, state->width, state->height, &processed);
+
+    CHECK_CALL(execute_render_graph, graph, state->postprocess ? processed : scene, vao, texture);
+
+    return last_status;
+}
+
+void free_postprocessing(postprocessing_t* postprocessing)
+{
+    if (postprocessing->program) glDeleteProgram(postprocessing->program);
+    if (postprocessing->blue_noise) glDeleteTextures(1, &postprocessing->blue_noise);
+    free_color_lut(&postprocessing->lut);
+    free_edge_detection(&postprocessing->edges);
+}
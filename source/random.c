@@ -0,0 +1,20 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/random.h"
+
+// xorshift32, generators give the same result on every platform.
+// The state must not be zero.
+float random_float(uint32_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (float)(*state >> 8) / (float)(1 << 24);
+}
+
+float random_range(uint32_t* state, float low, float high)
+{
+    return low + (high - low) * random_float(state);
+}
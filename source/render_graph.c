@@ -0,0 +1,171 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/render_graph.h"
+#include "../include/framebuffer.h"
+
+// Forget the passes of the previous frame, the pool keeps its targets
+void begin_render_graph(render_graph_t* graph)
+{
+    graph->pass_count = 0;
+    graph->resource_count = 0;
+}
+
+static int new_resource(render_graph_t* graph, GLuint texture, int producer, int* resource)
+{
+    if (graph->resource_count == RENDER_GRAPH_MAX_RESOURCES) return PG_INSUFFICIENT_MEMORY;
+
+    render_resource_t* added = &graph->resources[graph->resource_count];
+    added->texture = texture;
+    added->producer = producer;
+    added->last_reader = -1;
+    added->target = -1;
+    *resource = graph->resource_count++;
+
+    return PG_SUCCESS;
+}
+
+// Texture produced outside of the graph, such as the output of a generator
+int import_render_texture(render_graph_t* graph, GLuint texture, int* resource)
+{
+    return new_resource(graph, texture, -1, resource);
+}
+
+// Declare a pass and get its output resource, nothing runs before execute_render_graph
+int add_render_pass(render_graph_t* graph, const render_pass_t* pass, int* output)
+{
+    int last_status = PG_SUCCESS;
+
+    if (graph->pass_count == RENDER_GRAPH_MAX_PASSES) return PG_INSUFFICIENT_MEMORY;
+    if (pass->input_count > RENDER_GRAPH_MAX_INPUTS) return PG_INVALID_PARAMETER;
+    for (int i = 0; i < pass->input_count; i++)
+    {
+        if (pass->inputs[i] < 0 || pass->inputs[i] >= graph->resource_count) return PG_INVALID_PARAMETER;
+    }
+
+    CHECK_CALL(new_resource, graph, 0, graph->pass_count, output);
+    render_pass_t* added = &graph->passes[graph->pass_count++];
+    *added = *pass;
+    added->output = *output;
+
+    return last_status;
+}
+
+// Pool target nobody holds at this point of the frame, preferably one of the right size
+static int acquire_target(render_graph_t* graph, int width, int height, int* target)
+{
+    int last_status = PG_SUCCESS;
+    int chosen = -1;
+
+    for (int i = 0; i < RENDER_GRAPH_POOL_SIZE; i++)
+    {
+        if (graph->pool_busy[i]) continue;
+        if (graph->pool[i].width == width && graph->pool[i].height == height)
+        {
+            chosen = i;
+            break;
+        }
+        if (chosen < 0) chosen = i;
+    }
+
+    if (chosen < 0)
+    {
+        fprintf(stderr, "Render graph needs more than %d targets at once\n", RENDER_GRAPH_POOL_SIZE);
+        return PG_INSUFFICIENT_MEMORY;
+    }
+
+    CHECK_CALL(resize_render_target, &graph->pool[chosen], width, height, GL_RGBA8);
+    graph->pool_busy[chosen] = 1;
+    *target = chosen;
+
+    return last_status;
+}
+
+static void run_pass(render_graph_t* graph, const render_pass_t* pass, GLuint vao)
+{
+    render_target_t* target = &graph->pool[graph->resources[pass->output].target];
+    bind_render_target(target);
+
+    glUseProgram(pass->program);
+    glUniform2f(glGetUniformLocation(pass->program, "resolution"), (float)target->width, (float)target->height);
+    for (int i = 0; i < pass->input_count; i++)
+    {
+        glUniform1i(glGetUniformLocation(pass->program, pass->samplers[i]), i);
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, graph->resources[pass->inputs[i]].texture);
+    }
+    if (pass->setup) pass->setup(pass->program, pass->user);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Run the passes the output depends on in declaration order and return its texture,
+// which stays valid until the graph is executed again
+int execute_render_graph(render_graph_t* graph, int output, GLuint vao, GLuint* texture)
+{
+    int last_status = PG_SUCCESS;
+    int live[RENDER_GRAPH_MAX_PASSES] = { 0 };
+    int needed[RENDER_GRAPH_MAX_RESOURCES] = { 0 };
+
+    if (output < 0 || output >= graph->resource_count) return PG_INVALID_PARAMETER;
+
+    // passes only read resources declared before them, a single backward sweep
+    // from the output finds every pass it depends on
+    needed[output] = 1;
+    for (int p = graph->pass_count - 1; p >= 0; p--)
+    {
+        const render_pass_t* pass = &graph->passes[p];
+        if (!needed[pass->output]) continue;
+
+        live[p] = 1;
+        for (int i = 0; i < pass->input_count; i++) needed[pass->inputs[i]] = 1;
+    }
+
+    for (int p = 0; p < graph->pass_count; p++)
+    {
+        if (!live[p]) continue;
+        for (int i = 0; i < graph->passes[p].input_count; i++)
+        {
+            graph->resources[graph->passes[p].inputs[i]].last_reader = p;
+        }
+    }
+
+    for (int i = 0; i < RENDER_GRAPH_POOL_SIZE; i++) graph->pool_busy[i] = 0;
+
+    for (int p = 0; p < graph->pass_count; p++)
+    {
+        if (!live[p]) continue;
+
+        const render_pass_t* pass = &graph->passes[p];
+        render_resource_t* written = &graph->resources[pass->output];
+        CHECK_CALL(acquire_target, graph, pass->width, pass->height, &written->target);
+        written->texture = graph->pool[written->target].texture;
+
+        run_pass(graph, pass, vao);
+
+        // inputs read for the last time give their target back to the pool
+        for (int i = 0; i < pass->input_count; i++)
+        {
+            render_resource_t* input = &graph->resources[pass->inputs[i]];
+            if (input->producer >= 0 && input->last_reader == p && pass->inputs[i] != output)
+            {
+                graph->pool_busy[input->target] = 0;
+            }
+        }
+    }
+
+    *texture = graph->resources[output].texture;
+
+    return last_status;
+}
+
+void free_render_graph(render_graph_t* graph)
+{
+    for (int i = 0; i < RENDER_GRAPH_POOL_SIZE; i++)
+    {
+        delete_render_target(&graph->pool[i]);
+    }
+}
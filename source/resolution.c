@@ -0,0 +1,164 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/resolution.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+#include "../include/callbacks.h"
+
+int init_dynamic_resolution(dynres_t* dynres)
+{
+    int last_status = PG_SUCCESS;
+
+    // keep values given on the command line
+    if (dynres->target_ms <= 0.0f) dynres->target_ms = DYNRES_DEFAULT_TARGET_MS;
+    if (dynres->min_scale <= 0.0f || dynres->min_scale > 1.0f) dynres->min_scale = DYNRES_DEFAULT_MIN_SCALE;
+    dynres->scale = 1.0f;
+    dynres->render_scale = 1.0f;
+    dynres->gpu_ms = 0.0f;
+    dynres->query_index = 0;
+
+    glGenQueries(DYNRES_QUERY_COUNT, dynres->queries);
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_upscale.glsl", &dynres->upscale_program);
+
+    printf("[>] Dynamic resolution: target %.1f ms, floor %.0f%%\n", dynres->target_ms, dynres->min_scale * 100.0f);
+
+    return last_status;
+}
+
+// Read back every finished timer query, never wait on a pending one
+static void collect_timings(dynres_t* dynres)
+{
+    for (int i = 0; i < DYNRES_QUERY_COUNT; i++)
+    {
+        if (!dynres->query_pending[i]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(dynres->queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(dynres->queries[i], GL_QUERY_RESULT, &elapsed);
+        dynres->query_pending[i] = 0;
+
+        // normalize to the cost of a native frame, fragment work scales with the pixel count
+        float pixel_ratio = dynres->query_scale[i] * dynres->query_scale[i];
+        float native_ms = (float)elapsed * 1e-6f / pixel_ratio;
+
+        if (dynres->gpu_ms > 0.0f)
+        {
+            dynres->gpu_ms += (native_ms - dynres->gpu_ms) * DYNRES_SMOOTHING;
+        }
+        else
+        {
+            dynres->gpu_ms = native_ms;
+        }
+    }
+}
+
+static void update_scale(dynres_t* dynres, int interacting)
+{
+    // full resolution as soon as the view settles
+    if (!interacting || dynres->gpu_ms <= 0.0f)
+    {
+        dynres->scale = 1.0f;
+        return;
+    }
+
+    float wanted = sqrtf(dynres->target_ms / dynres->gpu_ms);
+    if (wanted > 1.0f) wanted = 1.0f;
+    if (wanted < dynres->min_scale) wanted = dynres->min_scale;
+
+    // damped to avoid oscillating around the target
+    dynres->scale += (wanted - dynres->scale) * DYNRES_DAMPING;
+}
+
+// The damped scale moves a little almost every frame, and every change of the render size
+// reallocates the offscreen target and the targets sized after it. The render size only
+// moves by whole steps, once the scale is three quarters of a step away from it.
+static void snap_scale(dynres_t* dynres)
+{
+    if (dynres->scale >= 1.0f)
+    {
+        dynres->render_scale = 1.0f;
+        return;
+    }
+    if (fabsf(dynres->scale - dynres->render_scale) < 0.75f * DYNRES_SCALE_STEP) return;
+
+    float snapped = roundf(dynres->scale / DYNRES_SCALE_STEP) * DYNRES_SCALE_STEP;
+    float lowest = ceilf(dynres->min_scale / DYNRES_SCALE_STEP) * DYNRES_SCALE_STEP;
+    if (snapped < lowest) snapped = lowest;
+    if (snapped > 1.0f) snapped = 1.0f;
+    dynres->render_scale = snapped;
+}
+
+// Pick the generator render size for this frame and start timing it.
+// The caller draws into dynres->target when the returned size is below native.
+int begin_dynamic_resolution(dynres_t* dynres, state_t* state, int* width, int* height)
+{
+    int last_status = PG_SUCCESS;
+
+    collect_timings(dynres);
+    update_scale(dynres, state->dynamic_resolution && is_interacting(state));
+    snap_scale(dynres);
+
+    *width = state->width;
+    *height = state->height;
+
+    if (dynres->render_scale < 1.0f)
+    {
+        *width = (int)(state->width * dynres->render_scale);
+        *height = (int)(state->height * dynres->render_scale);
+        CHECK_CALL(resize_render_target, &dynres->target, *width, *height, GL_RGBA8);
+        PRINT("Rendering at %dx%d", *width, *height);
+    }
+
+    // skip timing if this slot has not been read back yet
+    int slot = dynres->query_index;
+    dynres->timing = !dynres->query_pending[slot];
+    if (dynres->timing)
+    {
+        dynres->query_scale[slot] = sqrtf((float)(*width * *height) / (float)(state->width * state->height));
+        glBeginQuery(GL_TIME_ELAPSED, dynres->queries[slot]);
+    }
+
+    return last_status;
+}
+
+// Stop timing and upscale the offscreen render to the window,
+// a null texture means the generator already drew to the window
+int end_dynamic_resolution(dynres_t* dynres, state_t* state, GLuint vao, GLuint texture)
+{
+    int last_status = PG_SUCCESS;
+
+    if (dynres->timing)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        dynres->query_pending[dynres->query_index] = 1;
+        dynres->query_index = (dynres->query_index + 1) % DYNRES_QUERY_COUNT;
+    }
+
+    if (texture)
+    {
+        unbind_render_target(state->width, state->height);
+
+        glUseProgram(dynres->upscale_program);
+        glUniform1i(glGetUniformLocation(dynres->upscale_program, "source_texture"), 0);
+        glUniform2f(glGetUniformLocation(dynres->upscale_program, "resolution"), (float)state->width, (float)state->height);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    return last_status;
+}
+
+void free_dynamic_resolution(dynres_t* dynres)
+{
+    if (dynres->queries[0]) glDeleteQueries(DYNRES_QUERY_COUNT, dynres->queries);
+    if (dynres->upscale_program) glDeleteProgram(dynres->upscale_program);
+    delete_render_target(&dynres->target);
+}
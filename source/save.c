@@ -4,41 +4,46 @@
 
 #include "../include/save.h"
 
-static int save_png_libpng(const char* filename, uint8_t *pixels, int w, int h)
+// Write RGB pixels, or palette indices when a palette of palette_size RGB entries is given
+static int save_png_libpng(const char* filename, const uint8_t* pixels, const uint8_t* palette, int palette_size, int w, int h)
 {
     png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (!png) 
+    if (!png)
     {
         return PG_ALLOCATION_ERROR;
     }
 
     png_infop info = png_create_info_struct(png);
-    if (!info) 
+    if (!info)
     {
         png_destroy_write_struct(&png, &info);
         return PG_ALLOCATION_ERROR;
     }
 
     FILE *fp = fopen(filename, "wb");
-    if (!fp) 
+    if (!fp)
     {
         png_destroy_write_struct(&png, &info);
         return PG_ACCESS_DENIED;
     }
 
     png_init_io(png, fp);
-    png_set_IHDR(png, info, w, h, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
-    png_colorp palette = (png_colorp)png_malloc(png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color));
+    int channels = palette ? 1 : 3;
+    int color_type = palette ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGB;
+    png_set_IHDR(png, info, w, h, 8, color_type, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
 
-    if (!palette) 
+    if (palette)
     {
-        fclose(fp);
-        png_destroy_write_struct(&png, &info);
-        return PG_ALLOCATION_ERROR;
+        png_color entries[PNG_MAX_PALETTE_LENGTH];
+        for (int i = 0; i < palette_size; i++)
+        {
+            entries[i].red = palette[3 * i];
+            entries[i].green = palette[3 * i + 1];
+            entries[i].blue = palette[3 * i + 2];
+        }
+        png_set_PLTE(png, info, entries, palette_size);
     }
-    png_set_PLTE(png, info, palette, PNG_MAX_PALETTE_LENGTH);
     png_write_info(png, info);
-    png_set_packing(png);
 
     png_bytepp rows = (png_bytepp)png_malloc(png, h * sizeof(png_bytep));
 
@@ -46,23 +51,21 @@ static int save_png_libpng(const char* filename, uint8_t *pixels, int w, int h)
     {
         fclose(fp);
         png_destroy_write_struct(&png, &info);
-        png_free(png, palette);
         return PG_ALLOCATION_ERROR;
     }
 
-    for (int i = 0; i < h; ++i) 
+    for (int i = 0; i < h; ++i)
     {
-        rows[i] = (png_bytep)(pixels + (h - i - 1) * w * 3);
+        rows[i] = (png_bytep)(pixels + (size_t)(h - i - 1) * w * channels);
     }
 
     png_write_image(png, rows);
     png_write_end(png, info);
 
     // cleanup
-    png_free(png, palette);
+    png_free(png, rows);
     png_destroy_write_struct(&png, &info);
     fclose(fp);
-    free(rows);
 
     printf("[>] Saved %s.\n", filename);
     return PG_SUCCESS;
@@ -75,15 +78,49 @@ int save_png(const char* filename, data_t* data)
     int w = data->state.width;
     int h = data->state.height;
     uint8_t* pixels = (uint8_t*)malloc(sizeof(uint8_t)*(w * h * 3));
+    uint8_t* indices = NULL;
+    uint8_t palette[3 * PALETTE_MAX_COLORS];
+    int palette_size = 0;
+    if (!pixels) return PG_ALLOCATION_ERROR;
+
     // copy pixels from screen
-    
     glEnable(GL_FRAMEBUFFER_SRGB);
     glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, w, h);
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
     glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*)pixels);
 
+    // real error diffusion needs the serial order of the pixels, it runs on the CPU
+    if (data->postprocessing.diffusion_kernel)
+    {
+        CHECK_CALL_GOTO_ERROR(diffuse_error, cleanup, pixels, w, h, 3, data->postprocessing.quantization_levels, data->postprocessing.diffusion_kernel);
+    }
+
+    // an indexed image is a third of the raw size and compresses better still
+    if (data->postprocessing.palette_colors)
+    {
+        indices = (uint8_t*)malloc((size_t)w * h);
+        if (!indices)
+        {
+            last_status = PG_ALLOCATION_ERROR;
+            goto cleanup;
+        }
+        CHECK_CALL_GOTO_ERROR(quantize_palette, cleanup, pixels, w * h, data->postprocessing.palette_colors,
+            data->postprocessing.palette_samples, palette, &palette_size, indices);
+    }
+
     // save the image
-    CHECK_CALL(save_png_libpng, filename, pixels, w, h);
+    if (indices)
+    {
+        CHECK_CALL_GOTO_ERROR(save_png_libpng, cleanup, filename, indices, palette, palette_size, w, h);
+    }
+    else
+    {
+        CHECK_CALL_GOTO_ERROR(save_png_libpng, cleanup, filename, pixels, NULL, 0, w, h);
+    }
+
+cleanup:
+    free(pixels);
+    free(indices);
 
     return last_status;
-}
\ No newline at end of file
+}
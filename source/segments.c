@@ -0,0 +1,67 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/segments.h"
+
+// A unit quad instanced over a buffer of start.xy end.xy segments,
+// the segment buffer is read as a per instance attribute
+int init_segment_renderer(segment_renderer_t* renderer, GLuint segment_buffer)
+{
+    int last_status = PG_SUCCESS;
+
+    float corners[] = 
+    {
+        0.0f, -1.0f,
+        1.0f, -1.0f,
+        0.0f,  1.0f,
+        1.0f,  1.0f
+    };
+
+    glGenVertexArrays(1, &renderer->vao);
+    glGenBuffers(1, &renderer->quad);
+    glBindVertexArray(renderer->vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->quad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, segment_buffer);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return last_status;
+}
+
+// Draw every segment as a quad covering its outline only, blended over the background
+// in the currently bound framebuffer. Transform is scale.xy offset.xy applied to the segments.
+void draw_segments(segment_renderer_t* renderer, GLuint program, GLsizei count, float thickness, 
+    const float* transform, int width, int height)
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)width, (float)height);
+    glUniform1f(glGetUniformLocation(program, "thickness"), thickness);
+    glUniform4f(glGetUniformLocation(program, "transform"), transform[0], transform[1], transform[2], transform[3]);
+    glUniform3f(glGetUniformLocation(program, "color2"), 0.5, 1.0, 0.7);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(renderer->vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
+
+void free_segment_renderer(segment_renderer_t* renderer)
+{
+    if (renderer->quad) glDeleteBuffers(1, &renderer->quad);
+    if (renderer->vao) glDeleteVertexArrays(1, &renderer->vao);
+}
@@ -13,6 +13,7 @@ static int choose_shaders_path(data_t* data, const char** vertex_path, const cha
     switch (type)
     {
     case PROCEDURAL:
+        *vertex_path = "shaders/vertex.glsl";
         switch(procedural)
         {
             case MANDELBROT:
@@ -23,11 +24,30 @@ static int choose_shaders_path(data_t* data, const char** vertex_path, const cha
                 *fragment_path = "shaders/fragment_canopy.glsl";
                 break;
 
+            case LSYSTEM:
+            case COLONIZATION:
+                *fragment_path = "shaders/fragment_segment.glsl";
+                *vertex_path = "shaders/vertex_segment.glsl";
+                break;
+
+            case POISSON:
+                *fragment_path = "shaders/fragment_poisson.glsl";
+                *vertex_path = "shaders/vertex_poisson.glsl";
+                break;
+
+            case FOREST:
+                *fragment_path = "shaders/fragment_segment.glsl";
+                *vertex_path = "shaders/vertex_forest.glsl";
+                break;
+
+            case VORONOI:
+                *fragment_path = "shaders/fragment_voronoi.glsl";
+                break;
+
             default:
                 return PG_INVALID_PARAMETER;
                 break;
         }
-        *vertex_path = "shaders/vertex.glsl";
         break;
     
     case IMAGE:
@@ -112,16 +132,12 @@ static int create_shader(const char* shader_path, int shader_type, GLuint* p_sha
     return last_status;
 }
 
-int create_shader_program(data_t* data) 
+int create_program(const char* vertex_shader_path, const char* fragment_shader_path, GLuint* p_program)
 {
     int last_status = PG_SUCCESS;
     GLint success;
     GLchar info_log[512];
 
-    const char* vertex_shader_path = NULL;
-    const char* fragment_shader_path = NULL;
-    CHECK_CALL(choose_shaders_path, data, &vertex_shader_path, &fragment_shader_path);
-
     GLuint vertex_shader;
     GLuint fragment_shader;
     CHECK_CALL(create_shader, vertex_shader_path, GL_VERTEX_SHADER, &vertex_shader);
@@ -142,6 +158,83 @@ int create_shader_program(data_t* data)
         return PG_FAIL;
     }
 
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    *p_program = shader_program;
+
+    return last_status;
+}
+
+// Vertex only program whose output varying is captured by transform feedback
+int create_feedback_program(const char* vertex_shader_path, const char* varying, GLuint* p_program)
+{
+    int last_status = PG_SUCCESS;
+    GLint success;
+    GLchar info_log[512];
+
+    GLuint vertex_shader;
+    CHECK_CALL(create_shader, vertex_shader_path, GL_VERTEX_SHADER, &vertex_shader);
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glTransformFeedbackVaryings(program, 1, &varying, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(program);
+
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) 
+    {
+        glGetProgramInfoLog(program, sizeof(info_log), NULL, info_log);
+        fprintf(stderr, "Feedback program linking failed: %s\n", info_log);
+        return PG_FAIL;
+    }
+
+    glDeleteShader(vertex_shader);
+
+    *p_program = program;
+
+    return last_status;
+}
+
+int create_compute_program(const char* compute_shader_path, GLuint* p_program)
+{
+    int last_status = PG_SUCCESS;
+    GLint success;
+    GLchar info_log[512];
+
+    GLuint compute_shader;
+    CHECK_CALL(create_shader_preprocessed, compute_shader_path, GL_COMPUTE_SHADER, &compute_shader);
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, compute_shader);
+    glLinkProgram(program);
+
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) 
+    {
+        glGetProgramInfoLog(program, sizeof(info_log), NULL, info_log);
+        fprintf(stderr, "Compute program linking failed: %s\n", info_log);
+        return PG_FAIL;
+    }
+
+    glDeleteShader(compute_shader);
+
+    *p_program = program;
+
+    return last_status;
+}
+
+int create_shader_program(data_t* data) 
+{
+    int last_status = PG_SUCCESS;
+
+    const char* vertex_shader_path = NULL;
+    const char* fragment_shader_path = NULL;
+    CHECK_CALL(choose_shaders_path, data, &vertex_shader_path, &fragment_shader_path);
+
+    GLuint shader_program;
+    CHECK_CALL(create_program, vertex_shader_path, fragment_shader_path, &shader_program);
+
     // Add debug prints here
     GLint pos_attrib = glGetAttribLocation(shader_program, "aPos");
     GLint tex_attrib = glGetAttribLocation(shader_program, "aTexCoord");
@@ -153,8 +246,5 @@ int create_shader_program(data_t* data)
 
     data->shader_program = shader_program;
 
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-
     return last_status;
 }
@@ -7,7 +7,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 
 static int get_file_size(const char* filename, size_t* size)
 {
@@ -62,44 +61,40 @@ static int read_file(const char* filename, const char** buf)
 
 // Very basic include processing
 // NOTE: Currently searches all base_paths sequentially and breaks on first success.
-// Do not reuse with complex/multiple includes
+// Included files are not processed themselves, do not nest includes
 static int process_includes(const char* base_path[], int base_path_size, const char* shader_source, char** buf) 
 {
     int last_status = PG_SUCCESS;
 
     const char* shader_start = shader_source;
     PRINT("Shader script\t %llu", strlen(shader_source));
-    char* result = strdup(shader_source);
 
-    const char* included_content = NULL;
-    size_t content_size = 0;
-    size_t total_added_size = 0;
-    size_t total_deleted_size = 0;
-    char* include_start = NULL;
-
-    if ((include_start = strstr(shader_start, "#include"))) 
-    {
-        result[include_start - shader_start] = '\0';
-    }
-    else
+    // every byte of the source is either kept or replaced by an included file
+    size_t result_size = strlen(shader_source) + 1;
+    char* result = (char*)malloc(result_size);
+    if (!result)
     {
-        *buf = result;
-        return last_status;
+        return PG_ALLOCATION_ERROR;
     }
+    result[0] = '\0';
 
-    PRINT("Shader header\t %llu", strlen(result));
-    char* quote_start = NULL;
-    char* quote_end = NULL;
+    const char* included_content = NULL;
+    const char* include_start = NULL;
     
     while ((include_start = strstr(shader_start, "#include")))
     {
         char filename[256];
-        content_size = 0;
-    
-        quote_start = strchr(include_start, '"');
-        quote_end = strchr(quote_start + 1, '"');
-        size_t filename_size = quote_end - quote_start - 1;
-        total_deleted_size += quote_end - include_start;
+        const char* quote_start = strchr(include_start, '"');
+        const char* quote_end = quote_start ? strchr(quote_start + 1, '"') : NULL;
+        size_t filename_size = quote_end ? (size_t)(quote_end - quote_start - 1) : 0;
+        if (!quote_end || filename_size >= sizeof(filename))
+        {
+            last_status = PG_INVALID_PARAMETER;
+            goto cleanup;
+        }
+
+        // keep the text preceding the directive
+        strncat(result, shader_start, include_start - shader_start);
         
         // Extract filename
         strncpy(filename, quote_start + 1, filename_size);
@@ -120,68 +115,87 @@ static int process_includes(const char* base_path[], int base_path_size, const c
             PRINT("Find file %s", full_path);
 
             // Read included file
-            CHECK_CALL_GOTO_ERROR(get_file_size, cleanup, full_path, &content_size);
-            total_added_size += content_size;
             CHECK_CALL_GOTO_ERROR(read_file, cleanup, full_path, &included_content);
+            break;
+        }
 
-            if (last_status == PG_SUCCESS) 
-            {
-                break;
-            }
+        if (!included_content)
+        {
+            fprintf(stderr, "Included shader not found: %s\n", filename);
+            last_status = PG_NOT_FOUND;
+            goto cleanup;
         }
 
-        PRINT("Shader subscript\t %llu", content_size);
-        result = (char*)realloc(result, strlen(result) + content_size + 1);
-        if (!result)
+        PRINT("Shader subscript\t %llu", strlen(included_content));
+        result_size += strlen(included_content);
+        char* grown = (char*)realloc(result, result_size);
+        if (!grown)
         {
-            return PG_ALLOCATION_ERROR;
+            last_status = PG_ALLOCATION_ERROR;
+            goto cleanup;
         }
+        result = grown;
 
-        strncat(result, included_content, content_size);
+        strcat(result, included_content);
         PRINT("Current file\t %llu", strlen(result));
 
-        shader_start = quote_end;
+        free((void*)included_content);
+        included_content = NULL;
+        shader_start = quote_end + 1;
     }
 
-    PRINT("Shader program\t %llu", strlen(shader_start));
-    PRINT("Shader with included subscript %llu", strlen(result) + strlen(shader_start));
-    PRINT("Expected size\t %llu", total_added_size + strlen(shader_source) - total_deleted_size);
-
-    assert(strlen(result) + strlen(shader_start) == total_added_size + strlen(shader_source) - total_deleted_size);
-    result = (char*)realloc(result, strlen(result) + strlen(shader_start));
-    if (!result)
-    {
-        return PG_ALLOCATION_ERROR;
-    }
-    strncat(result, shader_start + 1, strlen(shader_start));
+    strcat(result, shader_start);
+    PRINT("Shader with included subscript %llu", strlen(result));
     
     *buf = result;
+    return last_status;
 
     cleanup:
     if((void*)included_content) free((void*)included_content);
+    free(result);
 
     return last_status;
 }
 
-int create_shader_fragment(const char* frag_path, GLuint* fragment_shader)
+int create_shader_preprocessed(const char* path, GLenum shader_type, GLuint* p_shader)
 {
     int last_status = PG_SUCCESS;
     const char* shader_file = NULL;
     const char* base_paths[2] = {"shaders/effects", "shaders/utils"};
     char* processed_shader = NULL;
+    GLint success;
+    GLchar info_log[512];
 
-    CHECK_CALL(read_file, frag_path, &shader_file);
+    CHECK_CALL(read_file, path, &shader_file);
     CHECK_CALL(process_includes, base_paths, 2, shader_file, &processed_shader);
 
     // Now use processed_shader with glShaderSource
-    GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+    GLuint shader = glCreateShader(shader_type);
     glShaderSource(shader, 1, (const GLchar**)&processed_shader, NULL);
     glCompileShader(shader);
     
     free(processed_shader);
     free((void*)shader_file);
+
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) 
+    {
+        glGetShaderInfoLog(shader, sizeof(info_log), NULL, info_log);
+        fprintf(stderr, "%s compilation failed: %s\n", path, info_log);
+        glDeleteShader(shader);
+        return PG_FAIL;
+    }
     
-    *fragment_shader = shader;
+    *p_shader = shader;
+
+    return last_status;
+}
+
+int create_shader_fragment(const char* frag_path, GLuint* fragment_shader)
+{
+    int last_status = PG_SUCCESS;
+
+    CHECK_CALL(create_shader_preprocessed, frag_path, GL_FRAGMENT_SHADER, fragment_shader);
 
     return last_status;
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/symmetry.h"
+
+// The Mandelbrot set is symmetric across the real axis: conj(c) has the same orbit modulus.
+// Returns 1 and fills the band if the real axis crosses a render of the given size.
+// Rows map to world with: y = ((4 (row + 0.5) / height) - 2) / zoom + offset_y
+int find_mirror_band(const state_t* state, int width, int height, mirror_band_t* band)
+{
+    UNREFERENCED_PARAMETER(width);
+
+    // twice the row coordinate of the axis, snapped so the axis lies on a row boundary
+    // or a row center and mirrored rows are exact, the view moves by half a row at most
+    float axis = (2.0f - state->offset[1] * state->zoom) * height / 4.0f;
+    int s = (int)lroundf(2.0f * axis);
+    if (s <= 1 || s >= 2 * height - 1) return 0;
+
+    band->offset_y = (2.0f - 2.0f * s / (float)height) / state->zoom;
+
+    // row j mirrors row s - 1 - j, render the larger side and flip it onto the other
+    int below = s / 2;
+    int above_start = s - below;
+    if (height - above_start >= below)
+    {
+        band->render_y0 = below;
+        band->render_y1 = height;
+        band->src_y0 = above_start;
+        band->src_y1 = s;
+        band->dst_y0 = below;
+        band->dst_y1 = 0;
+    }
+    else
+    {
+        band->render_y0 = 0;
+        band->render_y1 = above_start;
+        band->src_y0 = s - height;
+        band->src_y1 = below;
+        band->dst_y0 = height;
+        band->dst_y1 = above_start;
+    }
+
+    return 1;
+}
+
+// Restrict shading to the rendered side
+void begin_mirror_band(const mirror_band_t* band, int width)
+{
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, band->render_y0, width, band->render_y1 - band->render_y0);
+}
+
+// Flip the rendered rows onto the mirrored side, within the same framebuffer
+// as both rectangles never overlap
+void end_mirror_band(const mirror_band_t* band, GLuint fbo, int width)
+{
+    glDisable(GL_SCISSOR_TEST);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(
+        0, band->src_y0, width, band->src_y1, 
+        0, band->dst_y0, width, band->dst_y1, 
+        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
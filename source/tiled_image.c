@@ -0,0 +1,331 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/tiled_image.h"
+#include "../include/framebuffer.h"
+#include "../include/render_graph.h"
+#include "../include/postprocessing.h"
+#include "../include/edge_detection.h"
+#include "../stb/include/stb_image.h"
+
+// RGBA rows of an image in reading order, top first
+struct row_reader_s
+{
+    FILE* file;
+    png_structp png;
+    png_infop info;
+    uint8_t* image;             // whole decode of the inputs libpng cannot stream
+    int width;
+    int height;
+    int next;
+};
+
+// RGB rows of the output, written as soon as a strip is done
+typedef struct row_writer_s
+{
+    FILE* file;
+    png_structp png;
+    png_infop info;
+} row_writer_t;
+
+static int start_row_reader(row_reader_t* reader, const char* path)
+{
+    png_byte signature[8];
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) return PG_ACCESS_DENIED;
+
+    if (fread(signature, 1, sizeof(signature), reader->file) == sizeof(signature) &&
+        !png_sig_cmp(signature, 0, sizeof(signature)))
+    {
+        reader->png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+        if (!reader->png) return PG_ALLOCATION_ERROR;
+        reader->info = png_create_info_struct(reader->png);
+        if (!reader->info) return PG_ALLOCATION_ERROR;
+        if (setjmp(png_jmpbuf(reader->png))) return PG_UNREADABLE_FILE;
+
+        png_init_io(reader->png, reader->file);
+        png_set_sig_bytes(reader->png, sizeof(signature));
+        png_read_info(reader->png, reader->info);
+
+        // Adam7 passes revisit every row, interlaced files are decoded whole below
+        if (png_get_interlace_type(reader->png, reader->info) == PNG_INTERLACE_NONE)
+        {
+            png_set_expand(reader->png);
+            png_set_strip_16(reader->png);
+            png_set_gray_to_rgb(reader->png);
+            png_set_filler(reader->png, 0xff, PNG_FILLER_AFTER);
+            png_read_update_info(reader->png, reader->info);
+
+            reader->width = (int)png_get_image_width(reader->png, reader->info);
+            reader->height = (int)png_get_image_height(reader->png, reader->info);
+            return PG_SUCCESS;
+        }
+    }
+
+    // memory is no longer bounded by the strip for these
+    int channels = 0;
+    printf("[>] %s cannot be streamed, decoding it whole.\n", path);
+    stbi_set_flip_vertically_on_load(0);
+    reader->image = stbi_load(path, &reader->width, &reader->height, &channels, 4);
+    if (!reader->image) return PG_EXTERNAL_ERROR;
+
+    return PG_SUCCESS;
+}
+
+// Non interlaced PNGs are streamed, only the rows asked for are ever in memory
+int open_row_reader(const char* path, row_reader_t** p_reader, int* width, int* height)
+{
+    int last_status = PG_SUCCESS;
+
+    row_reader_t* reader = (row_reader_t*)calloc(1, sizeof(row_reader_t));
+    if (!reader) return PG_ALLOCATION_ERROR;
+
+    last_status = start_row_reader(reader, path);
+    if (last_status)
+    {
+        close_row_reader(reader);
+        return last_status;
+    }
+
+    *p_reader = reader;
+    *width = reader->width;
+    *height = reader->height;
+
+    return last_status;
+}
+
+// The next count rows, stride bytes apart
+int read_rows(row_reader_t* reader, uint8_t* rows, int count, size_t stride)
+{
+    if (reader->next + count > reader->height) return PG_INVALID_PARAMETER;
+
+    if (reader->image)
+    {
+        memcpy(rows, reader->image + (size_t)reader->next * stride, (size_t)count * stride);
+    }
+    else
+    {
+        if (setjmp(png_jmpbuf(reader->png))) return PG_UNREADABLE_FILE;
+        for (int i = 0; i < count; i++) png_read_row(reader->png, rows + (size_t)i * stride, NULL);
+    }
+    reader->next += count;
+
+    return PG_SUCCESS;
+}
+
+void close_row_reader(row_reader_t* reader)
+{
+    if (!reader) return;
+    if (reader->png) png_destroy_read_struct(&reader->png, reader->info ? &reader->info : NULL, NULL);
+    if (reader->file) fclose(reader->file);
+    if (reader->image) stbi_image_free(reader->image);
+    free(reader);
+}
+
+static int open_row_writer(row_writer_t* writer, const char* path, int width, int height)
+{
+    writer->png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (!writer->png) return PG_ALLOCATION_ERROR;
+    writer->info = png_create_info_struct(writer->png);
+    if (!writer->info) return PG_ALLOCATION_ERROR;
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) return PG_ACCESS_DENIED;
+    if (setjmp(png_jmpbuf(writer->png))) return PG_EXTERNAL_ERROR;
+
+    png_init_io(writer->png, writer->file);
+    png_set_IHDR(writer->png, writer->info, width, height, 8, PNG_COLOR_TYPE_RGB,
+        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_write_info(writer->png, writer->info);
+
+    return PG_SUCCESS;
+}
+
+static int write_rows(row_writer_t* writer, const uint8_t* rows, int count, size_t stride)
+{
+    if (setjmp(png_jmpbuf(writer->png))) return PG_EXTERNAL_ERROR;
+    for (int i = 0; i < count; i++) png_write_row(writer->png, (png_const_bytep)(rows + (size_t)i * stride));
+
+    return PG_SUCCESS;
+}
+
+static int end_row_writer(row_writer_t* writer)
+{
+    if (setjmp(png_jmpbuf(writer->png))) return PG_EXTERNAL_ERROR;
+    png_write_end(writer->png, writer->info);
+
+    return PG_SUCCESS;
+}
+
+static void close_row_writer(row_writer_t* writer)
+{
+    if (writer->png) png_destroy_write_struct(&writer->png, writer->info ? &writer->info : NULL);
+    if (writer->file) fclose(writer->file);
+}
+
+// Tiles only when the image does not fit in a texture, or is larger than a forced tile size
+int init_tiled_image(tiled_image_t* tiled, int width, int height)
+{
+    int last_status = PG_SUCCESS;
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+    int limit = tiled->tile_size ? tiled->tile_size : max_size;
+    tiled->active = width > limit || height > limit;
+    if (!tiled->active) return last_status;
+
+    // the overlap is uploaded with the tile
+    if (!tiled->tile_size) tiled->tile_size = TILED_IMAGE_TILE_SIZE;
+    if (tiled->tile_size > max_size - 2 * TILED_IMAGE_OVERLAP) tiled->tile_size = max_size - 2 * TILED_IMAGE_OVERLAP;
+    if (tiled->tile_size < 1) return PG_INVALID_PARAMETER;
+    if (!tiled->output) tiled->output = TILED_IMAGE_OUTPUT;
+
+    printf("[>] Image of %dx%d processed in tiles of %d, textures up to %d.\n", width, height, tiled->tile_size, max_size);
+
+    return last_status;
+}
+
+// Post-process the tile starting at column x of the strip rows, both including their overlap,
+// and read it back as RGB
+static int process_tile(tiled_image_t* tiled, postprocessing_t* postprocessing, render_graph_t* graph, GLuint vao,
+    const uint8_t* rows, int row_length, int x, int y, int width, int height, uint8_t* texels)
+{
+    int last_status = PG_SUCCESS;
+    int source = 0;
+    int edges = 0;
+    int processed = 0;
+    GLuint edge_texture = 0;
+    GLuint texture = 0;
+
+    CHECK_CALL(resize_render_target, &tiled->tile, width, height, GL_RGBA8);
+    glBindTexture(GL_TEXTURE_2D, tiled->tile.texture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rows + (size_t)x * 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    CHECK_CALL(detect_edges, &postprocessing->edges, tiled->tile.texture, width, height, &edge_texture);
+
+    // the patterns follow the pixels of the image, not those of the tile
+    postprocessing->pixel_offset[0] = x;
+    postprocessing->pixel_offset[1] = y;
+
+    begin_render_graph(graph);
+    CHECK_CALL(import_render_texture, graph, tiled->tile.texture, &source);
+    CHECK_CALL(import_render_texture, graph, edge_texture, &edges);
+    CHECK_CALL(add_postprocessing_pass, postprocessing, graph, source, edges, width, height, &processed);
+    CHECK_CALL(execute_render_graph, graph, processed, vao, &texture);
+
+    postprocessing->pixel_offset[0] = 0;
+    postprocessing->pixel_offset[1] = 0;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, texels);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return last_status;
+}
+
+// Decode, post-process and write the image one strip of tiles at a time. Tiles are uploaded
+// with an overlap covering the taps of the filters and cropped back, so the seams are invisible.
+// Memory holds a strip and one tile, whatever the height of the image.
+int process_tiled_image(tiled_image_t* tiled, postprocessing_t* postprocessing, render_graph_t* graph,
+    GLuint vao, const char* path)
+{
+    int last_status = PG_SUCCESS;
+    row_reader_t* reader = NULL;
+    row_writer_t writer = { 0 };
+    int width = 0;
+    int height = 0;
+    uint8_t* input = NULL;
+    uint8_t* output = NULL;
+    uint8_t* texels = NULL;
+    int size = tiled->tile_size;
+    int overlap = TILED_IMAGE_OVERLAP;
+    double start = glfwGetTime();
+
+    if (postprocessing->diffusion_kernel || postprocessing->palette_colors)
+    {
+        printf("[>] Error diffusion and palettes need the whole image, ignored for tiled images.\n");
+        postprocessing->diffusion_kernel = DIFFUSION_NONE;
+    }
+
+    CHECK_CALL_GOTO_ERROR(open_row_reader, cleanup, path, &reader, &width, &height);
+    CHECK_CALL_GOTO_ERROR(open_row_writer, cleanup, &writer, tiled->output, width, height);
+    CHECK_CALL_GOTO_ERROR(prepare_postprocessing, cleanup, postprocessing);
+
+    size_t input_stride = (size_t)width * 4;
+    size_t output_stride = (size_t)width * 3;
+    int window = size + 2 * overlap;
+    input = (uint8_t*)malloc(input_stride * window);
+    output = (uint8_t*)malloc(output_stride * size);
+    texels = (uint8_t*)malloc((size_t)window * window * 3);
+    if (!input || !output || !texels)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    // input holds the rows [first, first + count) of the image
+    int first = 0;
+    int count = 0;
+    for (int y0 = 0; y0 < height; y0 += size)
+    {
+        int y1 = y0 + size < height ? y0 + size : height;
+        int top = y0 - overlap > 0 ? y0 - overlap : 0;
+        int bottom = y1 + overlap < height ? y1 + overlap : height;
+
+        // the overlap of the strip above is kept, the rows before it dropped
+        if (top > first)
+        {
+            count -= top - first;
+            memmove(input, input + (size_t)(top - first) * input_stride, (size_t)count * input_stride);
+            first = top;
+        }
+        CHECK_CALL_GOTO_ERROR(read_rows, cleanup, reader, input + (size_t)count * input_stride,
+            bottom - first - count, input_stride);
+        count = bottom - first;
+
+        for (int x0 = 0; x0 < width; x0 += size)
+        {
+            int x1 = x0 + size < width ? x0 + size : width;
+            int left = x0 - overlap > 0 ? x0 - overlap : 0;
+            int right = x1 + overlap < width ? x1 + overlap : width;
+            int tile_width = right - left;
+
+            CHECK_CALL_GOTO_ERROR(process_tile, cleanup, tiled, postprocessing, graph, vao, input, width,
+                left, top, tile_width, bottom - top, texels);
+
+            // crop the overlap
+            for (int y = y0; y < y1; y++)
+            {
+                memcpy(output + (size_t)(y - y0) * output_stride + (size_t)x0 * 3,
+                    texels + ((size_t)(y - top) * tile_width + (x0 - left)) * 3, (size_t)(x1 - x0) * 3);
+            }
+        }
+
+        CHECK_CALL_GOTO_ERROR(write_rows, cleanup, &writer, output, y1 - y0, output_stride);
+        printf("[>] Tiled image: %d of %d rows written.\n", y1, height);
+    }
+
+    CHECK_CALL_GOTO_ERROR(end_row_writer, cleanup, &writer);
+    printf("[>] Saved %s in %.2f s.\n", tiled->output, glfwGetTime() - start);
+
+cleanup:
+    free(input);
+    free(output);
+    free(texels);
+    close_row_reader(reader);
+    close_row_writer(&writer);
+
+    return last_status;
+}
+
+void free_tiled_image(tiled_image_t* tiled)
+{
+    delete_render_target(&tiled->tile);
+}
@@ -0,0 +1,843 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+// fseeko / ftello with 64 bit offsets, page files can outgrow a long.
+// Must come before any system header.
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "../include/virtual_texture.h"
+#include "../include/framebuffer.h"
+#include "../include/shaders.h"
+#include "../include/tiled_image.h"
+
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+#define SLOT_BYTES ((size_t)VIRTUAL_TEXTURE_SLOT_SIZE * VIRTUAL_TEXTURE_SLOT_SIZE * 4)
+#define CACHE_SLOTS (VIRTUAL_TEXTURE_CACHE_COLUMNS * VIRTUAL_TEXTURE_CACHE_COLUMNS)
+#define PINNED UINT32_MAX           // slot_used of the top page, never evicted
+#define MAX_TABLE_SIZE 32768        // feedback texels pack the page column and row in 16 bits each
+
+#ifdef _WIN32
+#define seek_file _fseeki64
+#define tell_file _ftelli64
+#else
+#define seek_file fseeko
+#define tell_file ftello
+#endif
+
+typedef enum PAGE_JOB_STATE
+{
+    JOB_FREE,
+    JOB_QUEUED,
+    JOB_LOADING,
+    JOB_LOADED,
+    JOB_FAILED,
+} PAGE_JOB_STATE;
+
+typedef struct page_job_s
+{
+    int page;
+    int state;
+    uint8_t* texels;            // SLOT_BYTES
+} page_job_t;
+
+// Reads pages from the page file on its own thread. Jobs are moved from
+// QUEUED to LOADING to LOADED or FAILED by the thread, every other change
+// belongs to the main thread, all under the lock.
+struct page_loader_s
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int started;
+    int quit;
+    FILE* file;
+    page_job_t jobs[VIRTUAL_TEXTURE_JOBS];
+};
+
+// Header of the page file, written last
+typedef struct page_file_header_s
+{
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t page_size;
+    int32_t border;
+    int32_t levels;
+    int32_t reserved;
+} page_file_header_t;
+
+// One level of the pyramid while the page file is built. The level keeps
+// the rows of its current page row and borders, and gets its rows from the
+// level below, averaged two by two.
+typedef struct level_builder_s
+{
+    int width;
+    int height;
+    int columns;
+    int rows;
+    int first_page;
+    uint8_t* buffer;            // rows [first, first + count) of the level
+    uint8_t* half;              // row handed to the next level
+    int first;
+    int count;
+    int received;
+    int page_row;               // next page row to write
+} level_builder_t;
+
+static uint64_t fnv1a(const void* data, size_t length, uint64_t hash)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// The page file is named after the image, its size and date, and the page layout
+static void page_file_path(const char* image, char* path, size_t length)
+{
+    struct stat info;
+    memset(&info, 0, sizeof(info));
+    stat(image, &info);
+
+    char description[1024];
+    snprintf(description, sizeof(description), "virtual texture %d page %d border %d size %lld modified %lld image %s",
+        VIRTUAL_TEXTURE_VERSION, VIRTUAL_TEXTURE_PAGE_SIZE, VIRTUAL_TEXTURE_BORDER,
+        (long long)info.st_size, (long long)info.st_mtime, image);
+    snprintf(path, length, VIRTUAL_TEXTURE_CACHE_DIR "/pages_%016llx.bin",
+        (unsigned long long)fnv1a(description, strlen(description), FNV_OFFSET));
+}
+
+// Pages of every level, down to a single page. Levels halve the image,
+// rounding up, so a page of a level covers 2x2 pages of the level below.
+static int page_geometry(virtual_texture_t* vt)
+{
+    int page = VIRTUAL_TEXTURE_PAGE_SIZE;
+    int columns = (vt->width + page - 1) / page;
+    int rows = (vt->height + page - 1) / page;
+
+    vt->table_size = 1;
+    vt->levels = 1;
+    while (vt->table_size < columns || vt->table_size < rows)
+    {
+        vt->table_size <<= 1;
+        vt->levels++;
+    }
+    if (vt->table_size > MAX_TABLE_SIZE || vt->levels > VIRTUAL_TEXTURE_MAX_LEVELS)
+    {
+        fprintf(stderr, "Image of %dx%d too large for a virtual texture\n", vt->width, vt->height);
+        return PG_INVALID_PARAMETER;
+    }
+
+    int pages = 0;
+    int entries = 0;
+    for (int level = 0; level < vt->levels; level++)
+    {
+        int scale = 1 << level;
+        int side = vt->table_size >> level;
+        vt->columns[level] = (columns + scale - 1) >> level;
+        vt->rows[level] = (rows + scale - 1) >> level;
+        vt->first_page[level] = pages;
+        vt->table_offset[level] = entries;
+        pages += vt->columns[level] * vt->rows[level];
+        entries += side * side;
+    }
+    vt->page_count = pages;
+
+    return PG_SUCCESS;
+}
+
+// Every page of the current page row, with its border clamped to the level
+static int write_page_row(const level_builder_t* level, FILE* file, uint8_t* slot)
+{
+    int page = VIRTUAL_TEXTURE_PAGE_SIZE;
+    int border = VIRTUAL_TEXTURE_BORDER;
+    int size = VIRTUAL_TEXTURE_SLOT_SIZE;
+    long long first = (long long)level->first_page + (long long)level->page_row * level->columns;
+
+    if (seek_file(file, (long long)sizeof(page_file_header_t) + first * (long long)SLOT_BYTES, SEEK_SET)) return PG_EXTERNAL_ERROR;
+
+    for (int column = 0; column < level->columns; column++)
+    {
+        for (int sy = 0; sy < size; sy++)
+        {
+            int y = level->page_row * page - border + sy;
+            y = y < 0 ? 0 : (y >= level->height ? level->height - 1 : y);
+            const uint8_t* row = level->buffer + (size_t)(y - level->first) * level->width * 4;
+            uint8_t* out = slot + (size_t)sy * size * 4;
+            for (int sx = 0; sx < size; sx++)
+            {
+                int x = column * page - border + sx;
+                x = x < 0 ? 0 : (x >= level->width ? level->width - 1 : x);
+                memcpy(out + 4 * sx, row + 4 * (size_t)x, 4);
+            }
+        }
+        if (fwrite(slot, SLOT_BYTES, 1, file) != 1) return PG_EXTERNAL_ERROR;
+    }
+
+    return PG_SUCCESS;
+}
+
+// Hands the next row to a level. Pairs of rows, or the last one alone,
+// go down to the next level, and page rows are written once their bottom
+// border arrived.
+static int push_row(level_builder_t* levels, int level_count, int index, const uint8_t* row, FILE* file, uint8_t* slot)
+{
+    int last_status = PG_SUCCESS;
+    level_builder_t* level = &levels[index];
+    size_t stride = (size_t)level->width * 4;
+    int y = level->received++;
+
+    memcpy(level->buffer + (size_t)level->count * stride, row, stride);
+    level->count++;
+
+    if (index + 1 < level_count && ((y & 1) || y == level->height - 1))
+    {
+        const uint8_t* above = level->buffer + (size_t)(y - (y & 1) - level->first) * stride;
+        const uint8_t* below = level->buffer + (size_t)(y - level->first) * stride;
+        for (int x = 0; x < levels[index + 1].width; x++)
+        {
+            int left = 4 * 2 * x;
+            int right = 2 * x + 1 < level->width ? left + 4 : left;
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = above[left + c] + above[right + c] + below[left + c] + below[right + c];
+                level->half[4 * x + c] = (uint8_t)((sum + 2) >> 2);
+            }
+        }
+        CHECK_CALL(push_row, levels, level_count, index + 1, level->half, file, slot);
+    }
+
+    while (level->page_row < level->rows)
+    {
+        int bottom = (level->page_row + 1) * VIRTUAL_TEXTURE_PAGE_SIZE + VIRTUAL_TEXTURE_BORDER;
+        if (bottom > level->height) bottom = level->height;
+        if (y < bottom - 1) break;
+
+        CHECK_CALL(write_page_row, level, file, slot);
+        level->page_row++;
+
+        // rows above the top border of the next page row are done with
+        int keep = level->page_row * VIRTUAL_TEXTURE_PAGE_SIZE - VIRTUAL_TEXTURE_BORDER;
+        if (level->page_row < level->rows && keep > level->first)
+        {
+            int dropped = keep - level->first;
+            level->count -= dropped;
+            memmove(level->buffer, level->buffer + (size_t)dropped * stride, (size_t)level->count * stride);
+            level->first = keep;
+        }
+    }
+
+    return last_status;
+}
+
+// Splits the image into pages of every level, streaming its rows once.
+// Only a page row and its borders of every level are held in memory.
+static int build_page_file(virtual_texture_t* vt, const char* image)
+{
+    int last_status = PG_SUCCESS;
+    row_reader_t* reader = NULL;
+    FILE* file = NULL;
+    uint8_t* row = NULL;
+    uint8_t* slot = NULL;
+    level_builder_t levels[VIRTUAL_TEXTURE_MAX_LEVELS];
+    memset(levels, 0, sizeof(levels));
+
+    CHECK_CALL_GOTO_ERROR(open_row_reader, cleanup, image, &reader, &vt->width, &vt->height);
+    CHECK_CALL_GOTO_ERROR(page_geometry, cleanup, vt);
+
+#ifdef _WIN32
+    _mkdir(VIRTUAL_TEXTURE_CACHE_DIR);
+#else
+    mkdir(VIRTUAL_TEXTURE_CACHE_DIR, 0755);
+#endif
+
+    file = fopen(vt->path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Cannot write page file %s\n", vt->path);
+        last_status = PG_ACCESS_DENIED;
+        goto cleanup;
+    }
+
+    // an empty header until every page is written, an interrupted build is redone
+    page_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        last_status = PG_EXTERNAL_ERROR;
+        goto cleanup;
+    }
+
+    int width = vt->width;
+    int height = vt->height;
+    for (int level = 0; level < vt->levels; level++)
+    {
+        levels[level].width = width;
+        levels[level].height = height;
+        levels[level].columns = vt->columns[level];
+        levels[level].rows = vt->rows[level];
+        levels[level].first_page = vt->first_page[level];
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        levels[level].buffer = (uint8_t*)malloc((size_t)levels[level].width * 4 * (VIRTUAL_TEXTURE_SLOT_SIZE + 1));
+        levels[level].half = (uint8_t*)malloc((size_t)width * 4);
+        if (!levels[level].buffer || !levels[level].half)
+        {
+            last_status = PG_ALLOCATION_ERROR;
+            goto cleanup;
+        }
+    }
+
+    size_t stride = (size_t)vt->width * 4;
+    row = (uint8_t*)malloc(stride);
+    slot = (uint8_t*)malloc(SLOT_BYTES);
+    if (!row || !slot)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (int y = 0; y < vt->height; y++)
+    {
+        CHECK_CALL_GOTO_ERROR(read_rows, cleanup, reader, row, 1, stride);
+        CHECK_CALL_GOTO_ERROR(push_row, cleanup, levels, vt->levels, 0, row, file, slot);
+    }
+
+    header.magic = VIRTUAL_TEXTURE_MAGIC;
+    header.version = VIRTUAL_TEXTURE_VERSION;
+    header.width = vt->width;
+    header.height = vt->height;
+    header.page_size = VIRTUAL_TEXTURE_PAGE_SIZE;
+    header.border = VIRTUAL_TEXTURE_BORDER;
+    header.levels = vt->levels;
+    if (seek_file(file, 0, SEEK_SET) || fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        last_status = PG_EXTERNAL_ERROR;
+    }
+
+cleanup:
+    for (int level = 0; level < VIRTUAL_TEXTURE_MAX_LEVELS; level++)
+    {
+        free(levels[level].buffer);
+        free(levels[level].half);
+    }
+    free(row);
+    free(slot);
+    if (file && fclose(file) && !last_status) last_status = PG_EXTERNAL_ERROR;
+    if (file && last_status) remove(vt->path);
+    close_row_reader(reader);
+    return last_status;
+}
+
+// Geometry of a page file built before, if it is complete
+static int read_page_file(virtual_texture_t* vt)
+{
+    int last_status = PG_SUCCESS;
+
+    FILE* file = fopen(vt->path, "rb");
+    if (!file) return PG_NOT_FOUND;
+
+    page_file_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != VIRTUAL_TEXTURE_MAGIC || header.version != VIRTUAL_TEXTURE_VERSION ||
+        header.page_size != VIRTUAL_TEXTURE_PAGE_SIZE || header.border != VIRTUAL_TEXTURE_BORDER ||
+        header.width <= 0 || header.height <= 0)
+    {
+        last_status = PG_UNREADABLE_FILE;
+        goto cleanup;
+    }
+
+    vt->width = header.width;
+    vt->height = header.height;
+    if (page_geometry(vt) || vt->levels != header.levels || seek_file(file, 0, SEEK_END))
+    {
+        last_status = PG_UNREADABLE_FILE;
+        goto cleanup;
+    }
+
+    long long length = (long long)tell_file(file);
+    if (length != (long long)sizeof(header) + (long long)vt->page_count * (long long)SLOT_BYTES)
+    {
+        last_status = PG_UNREADABLE_FILE;
+    }
+
+cleanup:
+    fclose(file);
+    return last_status;
+}
+
+static int read_page(FILE* file, int page, uint8_t* texels)
+{
+    if (seek_file(file, (long long)sizeof(page_file_header_t) + (long long)page * (long long)SLOT_BYTES, SEEK_SET)) return PG_UNREADABLE_FILE;
+    return fread(texels, SLOT_BYTES, 1, file) == 1 ? PG_SUCCESS : PG_UNREADABLE_FILE;
+}
+
+// Coarsest queued job, so the holes of the screen are filled by a rough page first.
+// Pages are stored from the finest level up, the coarsest has the highest index.
+static int next_job(const page_loader_t* loader)
+{
+    int next = -1;
+    for (int j = 0; j < VIRTUAL_TEXTURE_JOBS; j++)
+    {
+        if (loader->jobs[j].state != JOB_QUEUED) continue;
+        if (next < 0 || loader->jobs[j].page > loader->jobs[next].page) next = j;
+    }
+    return next;
+}
+
+static void* load_pages(void* arg)
+{
+    page_loader_t* loader = (page_loader_t*)arg;
+
+    pthread_mutex_lock(&loader->lock);
+    while (!loader->quit)
+    {
+        int j = next_job(loader);
+        if (j < 0)
+        {
+            pthread_cond_wait(&loader->wake, &loader->lock);
+            continue;
+        }
+
+        page_job_t* job = &loader->jobs[j];
+        job->state = JOB_LOADING;
+        pthread_mutex_unlock(&loader->lock);
+
+        int status = read_page(loader->file, job->page, job->texels);
+
+        pthread_mutex_lock(&loader->lock);
+        job->state = status ? JOB_FAILED : JOB_LOADED;
+    }
+    pthread_mutex_unlock(&loader->lock);
+
+    return NULL;
+}
+
+static int open_page_loader(virtual_texture_t* vt)
+{
+    page_loader_t* loader = (page_loader_t*)calloc(1, sizeof(page_loader_t));
+    if (!loader) return PG_ALLOCATION_ERROR;
+
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->wake, NULL);
+    vt->loader = loader;
+
+    for (int j = 0; j < VIRTUAL_TEXTURE_JOBS; j++)
+    {
+        loader->jobs[j].texels = (uint8_t*)malloc(SLOT_BYTES);
+        if (!loader->jobs[j].texels) return PG_ALLOCATION_ERROR;
+    }
+
+    loader->file = fopen(vt->path, "rb");
+    if (!loader->file) return PG_UNREADABLE_FILE;
+
+    return PG_SUCCESS;
+}
+
+static void close_page_loader(page_loader_t* loader)
+{
+    if (!loader) return;
+
+    if (loader->started)
+    {
+        pthread_mutex_lock(&loader->lock);
+        loader->quit = 1;
+        pthread_cond_broadcast(&loader->wake);
+        pthread_mutex_unlock(&loader->lock);
+        pthread_join(loader->thread, NULL);
+    }
+
+    pthread_mutex_destroy(&loader->lock);
+    pthread_cond_destroy(&loader->wake);
+    for (int j = 0; j < VIRTUAL_TEXTURE_JOBS; j++) free(loader->jobs[j].texels);
+    if (loader->file) fclose(loader->file);
+    free(loader);
+}
+
+static void upload_page(virtual_texture_t* vt, int slot, const uint8_t* texels)
+{
+    int x = slot % VIRTUAL_TEXTURE_CACHE_COLUMNS * VIRTUAL_TEXTURE_SLOT_SIZE;
+    int y = slot / VIRTUAL_TEXTURE_CACHE_COLUMNS * VIRTUAL_TEXTURE_SLOT_SIZE;
+
+    glBindTexture(GL_TEXTURE_2D, vt->cache);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, VIRTUAL_TEXTURE_SLOT_SIZE, VIRTUAL_TEXTURE_SLOT_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    vt->table_dirty = 1;
+}
+
+static int allocate_tables(virtual_texture_t* vt)
+{
+    size_t entries = (size_t)vt->table_offset[vt->levels - 1] + 1;
+
+    vt->page_slot = (int*)malloc(sizeof(int) * vt->page_count);
+    vt->page_pending = (uint8_t*)calloc(vt->page_count, 1);
+    vt->page_stamp = (uint32_t*)calloc(vt->page_count, sizeof(uint32_t));
+    vt->wanted = (int*)malloc(sizeof(int) * vt->page_count);
+    vt->slot_page = (int*)malloc(sizeof(int) * CACHE_SLOTS);
+    vt->slot_used = (uint32_t*)calloc(CACHE_SLOTS, sizeof(uint32_t));
+    vt->table = (uint8_t*)calloc(entries, 4);
+    if (!vt->page_slot || !vt->page_pending || !vt->page_stamp || !vt->wanted ||
+        !vt->slot_page || !vt->slot_used || !vt->table)
+    {
+        return PG_ALLOCATION_ERROR;
+    }
+
+    for (int p = 0; p < vt->page_count; p++) vt->page_slot[p] = -1;
+    for (int s = 0; s < CACHE_SLOTS; s++) vt->slot_page[s] = -1;
+
+    return PG_SUCCESS;
+}
+
+// Page cache, page table and the page file of the image, built on first use.
+// The top page is loaded now and stays, every pixel has something to show.
+int init_virtual_texture(virtual_texture_t* vt, const char* image)
+{
+    int last_status = PG_SUCCESS;
+
+    page_file_path(image, vt->path, sizeof(vt->path));
+    if (read_page_file(vt))
+    {
+        double start = glfwGetTime();
+        CHECK_CALL(build_page_file, vt, image);
+        printf("[>] Page file %s built in %.2f s\n", vt->path, glfwGetTime() - start);
+    }
+    printf("[>] Virtual texture of %dx%d, %d pages over %d levels\n", vt->width, vt->height, vt->page_count, vt->levels);
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    if (vt->table_size > max_size)
+    {
+        fprintf(stderr, "Page table of %d exceeds the texture size limit of %d\n", vt->table_size, max_size);
+        return PG_INVALID_PARAMETER;
+    }
+
+    CHECK_CALL(allocate_tables, vt);
+    CHECK_CALL(open_page_loader, vt);
+
+    int cache_size = VIRTUAL_TEXTURE_CACHE_COLUMNS * VIRTUAL_TEXTURE_SLOT_SIZE;
+    glGenTextures(1, &vt->cache);
+    glBindTexture(GL_TEXTURE_2D, vt->cache);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cache_size, cache_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // one mip per level, an entry per page of the level
+    glGenTextures(1, &vt->table_texture);
+    glBindTexture(GL_TEXTURE_2D, vt->table_texture);
+    for (int level = 0; level < vt->levels; level++)
+    {
+        int side = vt->table_size >> level;
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8UI, side, side, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, vt->levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    int top = vt->page_count - 1;
+    CHECK_CALL(read_page, vt->loader->file, top, vt->loader->jobs[0].texels);
+    upload_page(vt, 0, vt->loader->jobs[0].texels);
+    vt->page_slot[top] = 0;
+    vt->slot_page[0] = top;
+    vt->slot_used[0] = PINNED;
+
+    CHECK_CALL(create_program, "shaders/vertex_fullscreen.glsl", "shaders/fragment_virtual_texture.glsl", &vt->program);
+    CHECK_CALL(create_program, "shaders/vertex_fullscreen.glsl", "shaders/fragment_page_feedback.glsl", &vt->feedback_program);
+    glGenVertexArrays(1, &vt->vao);
+    glGenBuffers(2, vt->pbo);
+
+    // without the thread, queued pages are read between frames
+    vt->loader->started = !pthread_create(&vt->loader->thread, NULL, load_pages, vt->loader);
+    if (!vt->loader->started) printf("[>] Page loader thread unavailable, pages are read between frames\n");
+
+    vt->frame = 1;
+
+    return last_status;
+}
+
+// Marks the page and its ancestors as seen this frame, the missing ones are wanted
+static void request_page(virtual_texture_t* vt, int level, int x, int y, int* wanted)
+{
+    for (; level < vt->levels; level++, x >>= 1, y >>= 1)
+    {
+        if (x >= vt->columns[level] || y >= vt->rows[level]) return;
+
+        int page = vt->first_page[level] + y * vt->columns[level] + x;
+        if (vt->page_stamp[page] == vt->frame) return;
+        vt->page_stamp[page] = vt->frame;
+
+        int slot = vt->page_slot[page];
+        if (slot >= 0)
+        {
+            if (vt->slot_used[slot] != PINNED) vt->slot_used[slot] = vt->frame;
+        }
+        else if (!vt->page_pending[page])
+        {
+            vt->wanted[(*wanted)++] = page;
+        }
+    }
+}
+
+// Feedback of the previous frame, read back without waiting on this one
+static void read_feedback(virtual_texture_t* vt, int* wanted)
+{
+    int previous = vt->pbo_index ^ 1;
+    int count = vt->pbo_width[previous] * vt->pbo_height[previous];
+    if (!count) return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, vt->pbo[previous]);
+    const GLint* texels = (const GLint*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)count * 2 * sizeof(GLint), GL_MAP_READ_BIT);
+    if (texels)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            GLint page = texels[2 * i];
+            GLint level = texels[2 * i + 1];
+            if (level < 0 || level >= vt->levels) continue;
+            request_page(vt, level, page & 0xffff, page >> 16, wanted);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+static int compare_pages(const void* a, const void* b)
+{
+    return *(const int*)b - *(const int*)a;
+}
+
+// Hands the wanted pages to free jobs, coarsest first
+static void queue_pages(virtual_texture_t* vt, int wanted)
+{
+    page_loader_t* loader = vt->loader;
+
+    qsort(vt->wanted, wanted, sizeof(int), compare_pages);
+
+    pthread_mutex_lock(&loader->lock);
+    for (int i = 0, j = 0; i < wanted && j < VIRTUAL_TEXTURE_JOBS; j++)
+    {
+        page_job_t* job = &loader->jobs[j];
+        if (job->state != JOB_FREE) continue;
+
+        job->page = vt->wanted[i++];
+        job->state = JOB_QUEUED;
+        vt->page_pending[job->page] = 1;
+    }
+    pthread_cond_signal(&loader->wake);
+    pthread_mutex_unlock(&loader->lock);
+}
+
+// Free slot, or the least recently seen one that is not on screen
+static int find_slot(const virtual_texture_t* vt)
+{
+    int oldest = -1;
+    for (int s = 0; s < CACHE_SLOTS; s++)
+    {
+        if (vt->slot_page[s] < 0) return s;
+        if (vt->slot_used[s] == vt->frame || vt->slot_used[s] == PINNED) continue;
+        if (oldest < 0 || vt->slot_used[s] < vt->slot_used[oldest]) oldest = s;
+    }
+    return oldest;
+}
+
+// Loaded pages into the cache, a few per frame so a jump never stalls a frame
+static void upload_pages(virtual_texture_t* vt)
+{
+    page_loader_t* loader = vt->loader;
+    int done[VIRTUAL_TEXTURE_JOBS];
+    int count = 0;
+
+    if (!loader->started)
+    {
+        for (int j = 0; j < VIRTUAL_TEXTURE_JOBS && count < VIRTUAL_TEXTURE_UPLOADS; j++)
+        {
+            page_job_t* job = &loader->jobs[j];
+            if (job->state != JOB_QUEUED) continue;
+            job->state = read_page(loader->file, job->page, job->texels) ? JOB_FAILED : JOB_LOADED;
+            count++;
+        }
+        count = 0;
+    }
+
+    // finished jobs belong to the main thread until they are freed
+    pthread_mutex_lock(&loader->lock);
+    for (int j = 0; j < VIRTUAL_TEXTURE_JOBS && count < VIRTUAL_TEXTURE_UPLOADS; j++)
+    {
+        if (loader->jobs[j].state == JOB_LOADED || loader->jobs[j].state == JOB_FAILED) done[count++] = j;
+    }
+    pthread_mutex_unlock(&loader->lock);
+
+    for (int i = 0; i < count; i++)
+    {
+        page_job_t* job = &loader->jobs[done[i]];
+        int slot = job->state == JOB_LOADED ? find_slot(vt) : -1;
+
+        // a failed page, or a full cache, is asked for again by the next feedback
+        if (slot >= 0)
+        {
+            if (vt->slot_page[slot] >= 0) vt->page_slot[vt->slot_page[slot]] = -1;
+            vt->slot_page[slot] = job->page;
+            vt->slot_used[slot] = vt->frame;
+            vt->page_slot[job->page] = slot;
+            upload_page(vt, slot, job->texels);
+        }
+        vt->page_pending[job->page] = 0;
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    for (int i = 0; i < count; i++) loader->jobs[done[i]].state = JOB_FREE;
+    pthread_mutex_unlock(&loader->lock);
+}
+
+// Rebuilds the page table from the top level down. A missing page points
+// to its closest resident ancestor, which the top page guarantees.
+static void update_page_table(virtual_texture_t* vt)
+{
+    glBindTexture(GL_TEXTURE_2D, vt->table_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    for (int level = vt->levels - 1; level >= 0; level--)
+    {
+        int side = vt->table_size >> level;
+        uint8_t* entries = vt->table + (size_t)vt->table_offset[level] * 4;
+        const uint8_t* parents = level + 1 < vt->levels ? vt->table + (size_t)vt->table_offset[level + 1] * 4 : NULL;
+
+        for (int y = 0; y < side; y++)
+        {
+            for (int x = 0; x < side; x++)
+            {
+                uint8_t* entry = entries + ((size_t)y * side + x) * 4;
+                int resident = x < vt->columns[level] && y < vt->rows[level];
+                int slot = resident ? vt->page_slot[vt->first_page[level] + y * vt->columns[level] + x] : -1;
+
+                if (slot >= 0)
+                {
+                    entry[0] = (uint8_t)(slot % VIRTUAL_TEXTURE_CACHE_COLUMNS);
+                    entry[1] = (uint8_t)(slot / VIRTUAL_TEXTURE_CACHE_COLUMNS);
+                    entry[2] = (uint8_t)level;
+                    entry[3] = 255;
+                }
+                else if (parents)
+                {
+                    memcpy(entry, parents + ((size_t)(y >> 1) * (side >> 1) + (x >> 1)) * 4, 4);
+                }
+                else
+                {
+                    memset(entry, 0, 4);
+                }
+            }
+        }
+
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, side, side, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, entries);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    vt->table_dirty = 0;
+}
+
+static void use_virtual_texture_program(const virtual_texture_t* vt, GLuint program, const state_t* state)
+{
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "resolution"), (float)state->width, (float)state->height);
+    glUniform1f(glGetUniformLocation(program, "zoom"), state->zoom);
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], state->offset[1]);
+    glUniform2f(glGetUniformLocation(program, "image_size"), (float)vt->width, (float)vt->height);
+    glUniform1i(glGetUniformLocation(program, "page_levels"), vt->levels);
+    glUniform1f(glGetUniformLocation(program, "page_size"), (float)VIRTUAL_TEXTURE_PAGE_SIZE);
+    glUniform1f(glGetUniformLocation(program, "page_border"), (float)VIRTUAL_TEXTURE_BORDER);
+    glUniform1f(glGetUniformLocation(program, "cache_size"), (float)(VIRTUAL_TEXTURE_CACHE_COLUMNS * VIRTUAL_TEXTURE_SLOT_SIZE));
+    glUniform1i(glGetUniformLocation(program, "page_table"), 0);
+    glUniform1i(glGetUniformLocation(program, "page_cache"), 1);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, vt->table_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, vt->cache);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(vt->vao);
+}
+
+// Streams the pages asked for by the last frames, then renders the view of
+// the image into vt->target at the window size. The feedback of this frame
+// is read back into a pixel buffer and used by the next one.
+int draw_virtual_texture(virtual_texture_t* vt, const state_t* state, GLuint* texture)
+{
+    int last_status = PG_SUCCESS;
+    int wanted = 0;
+
+    read_feedback(vt, &wanted);
+    if (wanted) queue_pages(vt, wanted);
+    upload_pages(vt);
+    if (vt->table_dirty) update_page_table(vt);
+
+    // page and level of every pixel, at a fraction of the window
+    int width = state->width / VIRTUAL_TEXTURE_FEEDBACK_SCALE;
+    int height = state->height / VIRTUAL_TEXTURE_FEEDBACK_SCALE;
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+
+    CHECK_CALL(resize_render_target, &vt->feedback, width, height, GL_RG32I);
+    bind_render_target(&vt->feedback);
+    use_virtual_texture_program(vt, vt->feedback_program, state);
+    glUniform1f(glGetUniformLocation(vt->feedback_program, "feedback_scale"), (float)VIRTUAL_TEXTURE_FEEDBACK_SCALE);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    int index = vt->pbo_index;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, vt->pbo[index]);
+    if (vt->pbo_width[index] != width || vt->pbo_height[index] != height)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 2 * sizeof(GLint), NULL, GL_STREAM_READ);
+        vt->pbo_width[index] = width;
+        vt->pbo_height[index] = height;
+    }
+    glReadPixels(0, 0, width, height, GL_RG_INTEGER, GL_INT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    vt->pbo_index ^= 1;
+
+    CHECK_CALL(resize_render_target, &vt->target, state->width, state->height, GL_RGBA8);
+    bind_render_target(&vt->target);
+    use_virtual_texture_program(vt, vt->program, state);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    *texture = vt->target.texture;
+    vt->frame++;
+
+    return last_status;
+}
+
+void free_virtual_texture(virtual_texture_t* vt)
+{
+    close_page_loader(vt->loader);
+    vt->loader = NULL;
+
+    if (vt->cache) glDeleteTextures(1, &vt->cache);
+    if (vt->table_texture) glDeleteTextures(1, &vt->table_texture);
+    if (vt->program) glDeleteProgram(vt->program);
+    if (vt->feedback_program) glDeleteProgram(vt->feedback_program);
+    if (vt->vao) glDeleteVertexArrays(1, &vt->vao);
+    if (vt->pbo[0]) glDeleteBuffers(2, vt->pbo);
+    delete_render_target(&vt->target);
+    delete_render_target(&vt->feedback);
+
+    free(vt->page_slot);
+    free(vt->page_pending);
+    free(vt->page_stamp);
+    free(vt->slot_page);
+    free(vt->slot_used);
+    free(vt->wanted);
+    free(vt->table);
+}
@@ -0,0 +1,130 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
+
+#include "../include/voronoi.h"
+#include "../include/jump_flood.h"
+#include "../include/shaders.h"
+
+int init_voronoi(voronoi_t* voronoi, state_t* state)
+{
+    int last_status = PG_SUCCESS;
+
+    // keep the count given on the command line
+    if (voronoi->seed_count <= 0) voronoi->seed_count = VORONOI_DEFAULT_SEEDS;
+
+    GLsizeiptr size = (GLsizeiptr)voronoi->seed_count * 2 * sizeof(float);
+    float* seeds = (float*)malloc((size_t)size);
+    if (!seeds) return PG_ALLOCATION_ERROR;
+
+    uint32_t random_state = VORONOI_SEED;
+    float half = 0.5f * VORONOI_DOMAIN;
+    for (int i = 0; i < 2 * voronoi->seed_count; i++)
+    {
+        seeds[i] = random_range(&random_state, -half, half);
+    }
+
+    glGenVertexArrays(1, &voronoi->vao);
+    glGenBuffers(1, &voronoi->buffer);
+    glBindVertexArray(voronoi->vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, voronoi->buffer);
+    glBufferData(GL_ARRAY_BUFFER, size, seeds, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    free(seeds);
+
+    // the flooding steps fetch the seed positions by index
+    glGenTextures(1, &voronoi->texture);
+    glBindTexture(GL_TEXTURE_BUFFER, voronoi->texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, voronoi->buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    CHECK_CALL(create_program, "shaders/vertex_voronoi_seed.glsl", "shaders/fragment_voronoi_seed.glsl", &voronoi->seed_program);
+    CHECK_CALL(create_program, "shaders/vertex.glsl", "shaders/fragment_voronoi_step.glsl", &voronoi->step_program);
+
+    // start where cells are a few pixels wide, seeds are domain / sqrt(count) apart on average
+    float spacing = VORONOI_DOMAIN / sqrtf((float)voronoi->seed_count);
+    state->zoom = 4.0f * VORONOI_START_SPACING / (spacing * (float)state->height);
+    if (state->zoom < 4.0f / VORONOI_DOMAIN) state->zoom = 4.0f / VORONOI_DOMAIN;
+    state->offset[0] = 0.0f;
+    state->offset[1] = 0.0f;
+
+    printf("[>] Voronoi: %d seeds\n", voronoi->seed_count);
+
+    return last_status;
+}
+
+// Field pixel of a world position is (p - offset) * pixel_scale + center, the view
+// of the other generators shifted by the guard band around the screen
+static void set_view_uniforms(GLuint program, const state_t* state, int width, int height)
+{
+    glUniform2f(glGetUniformLocation(program, "offset"), state->offset[0], state->offset[1]);
+    glUniform1f(glGetUniformLocation(program, "pixel_scale"), state->zoom * (float)height / 4.0f);
+    glUniform2f(glGetUniformLocation(program, "center"), 0.5f * width + VORONOI_GUARD, 0.5f * height + VORONOI_GUARD);
+}
+
+// Splat the seeds as points, flood their index over the screen in log2(resolution) passes,
+// then shade the cells from their two nearest seeds into the framebuffer bound by the caller
+int draw_voronoi(voronoi_t* voronoi, jump_flood_t* jump_flood, GLuint program, const state_t* state, 
+    GLuint vao, int width, int height)
+{
+    int last_status = PG_SUCCESS;
+
+    GLint target = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+
+    // seeds just off screen still own cells on screen
+    int field_width = width + 2 * VORONOI_GUARD;
+    int field_height = height + 2 * VORONOI_GUARD;
+    CHECK_CALL(begin_jump_flood_seeds, jump_flood, field_width, field_height, GL_RG32I);
+
+    glUseProgram(voronoi->seed_program);
+    set_view_uniforms(voronoi->seed_program, state, width, height);
+    glUniform2f(glGetUniformLocation(voronoi->seed_program, "field_size"), (float)field_width, (float)field_height);
+    glBindVertexArray(voronoi->vao);
+    glDrawArrays(GL_POINTS, 0, voronoi->seed_count);
+
+    glUseProgram(voronoi->step_program);
+    set_view_uniforms(voronoi->step_program, state, width, height);
+    glUniform1i(glGetUniformLocation(voronoi->step_program, "seed_texture"), 1);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, voronoi->texture);
+
+    GLuint field = 0;
+    run_jump_flood(jump_flood, voronoi->step_program, 0, vao, &field);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)target);
+    glViewport(0, 0, width, height);
+
+    float pixel_scale = state->zoom * (float)height / 4.0f;
+    glUseProgram(program);
+    set_view_uniforms(program, state, width, height);
+    glUniform1i(glGetUniformLocation(program, "field_texture"), 0);
+    glUniform1i(glGetUniformLocation(program, "seed_texture"), 1);
+    glUniform1i(glGetUniformLocation(program, "guard"), VORONOI_GUARD);
+    glUniform1f(glGetUniformLocation(program, "spacing"), VORONOI_DOMAIN / sqrtf((float)voronoi->seed_count) * pixel_scale);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, field);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    return last_status;
+}
+
+void free_voronoi(voronoi_t* voronoi)
+{
+    if (voronoi->seed_program) glDeleteProgram(voronoi->seed_program);
+    if (voronoi->step_program) glDeleteProgram(voronoi->step_program);
+    if (voronoi->texture) glDeleteTextures(1, &voronoi->texture);
+    if (voronoi->buffer) glDeleteBuffers(1, &voronoi->buffer);
+    if (voronoi->vao) glDeleteVertexArrays(1, &voronoi->vao);
+}
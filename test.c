@@ -3,9 +3,461 @@
 // This file is part of procedural_generation project from https://github.com/remyCases/procedural_generation.
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "include/error.h"
+#include "include/random.h"
+#include "include/colonization.h"
+#include "include/poisson.h"
+#include "include/error_diffusion.h"
+#include "include/blue_noise.h"
+#include "include/palette.h"
+
+#define TEST_SEED 0x9e3779b9u
+
+typedef int (*test_function_t)(void);
+
+typedef struct test_s
+{
+    const char* name;
+    test_function_t run;
+} test_t;
+
+// The grid search only looks at the 3x3 cells around a point and at the nodes
+// added since the last search, a linear scan over every node must agree
+static int test_colonization_nearest(void)
+{
+    int last_status = PG_SUCCESS;
+    const int point_count = 4000;
+    const int node_count = 1500;
+    const int batches[] = { 1, 7, 250, 1500 };
+
+    float* points = (float*)malloc((size_t)point_count * 2 * sizeof(float));
+    float* nodes = (float*)malloc((size_t)node_count * 2 * sizeof(float));
+    int* nearest = (int*)malloc((size_t)point_count * sizeof(int));
+    if (!points || !nodes || !nearest)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    // a little past the grid, the border cells are clamped
+    uint32_t seed = TEST_SEED;
+    for (int p = 0; p < 2 * point_count; p++) points[p] = random_range(&seed, -1.1f, 1.1f);
+    for (int n = 0; n < 2 * node_count; n++) nodes[n] = random_range(&seed, -1.1f, 1.1f);
+
+    for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]) && !last_status; b++)
+    {
+        CHECK_CALL_GOTO_ERROR(search_nearest_nodes, cleanup, points, point_count, nodes, node_count, batches[b], nearest);
+
+        for (int p = 0; p < point_count; p++)
+        {
+            float best = COLONIZATION_INFLUENCE * COLONIZATION_INFLUENCE;
+            int expected = -1;
+            for (int n = 0; n < node_count; n++)
+            {
+                float dx = nodes[2 * n] - points[2 * p];
+                float dy = nodes[2 * n + 1] - points[2 * p + 1];
+                float d = dx * dx + dy * dy;
+                if (d < best)
+                {
+                    best = d;
+                    expected = n;
+                }
+            }
+
+            // ties may pick another node at the same distance
+            int found = nearest[p];
+            float dx = found >= 0 ? nodes[2 * found] - points[2 * p] : 0.0f;
+            float dy = found >= 0 ? nodes[2 * found + 1] - points[2 * p + 1] : 0.0f;
+            if ((found < 0) != (expected < 0) || (found >= 0 && dx * dx + dy * dy != best))
+            {
+                fprintf(stderr, "Point %d, batches of %d: nearest node %d, expected %d\n", p, batches[b], found, expected);
+                last_status = PG_FAIL;
+                break;
+            }
+        }
+    }
+
+cleanup:
+    free(points);
+    free(nodes);
+    free(nearest);
+    return last_status;
+}
+
+// No two points closer than the largest of their radii, across tile borders too
+static int check_poisson_spacing(const float* points, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = i + 1; j < count; j++)
+        {
+            float dx = points[3 * j] - points[3 * i];
+            float dy = points[3 * j + 1] - points[3 * i + 1];
+            float d = fmaxf(points[3 * i + 2], points[3 * j + 2]);
+            if (dx * dx + dy * dy < d * d)
+            {
+                fprintf(stderr, "Points %d and %d are %f apart, closer than %f\n", i, j, sqrtf(dx * dx + dy * dy), d);
+                return PG_FAIL;
+            }
+        }
+    }
+
+    return PG_SUCCESS;
+}
+
+// Tiles of a phase only read the cells of their neighbors from the previous phases,
+// so the points must be spaced and must not depend on the number of threads
+static int test_poisson_disk(void)
+{
+    int last_status = PG_SUCCESS;
+    const float radius = 0.01f;
+    const float domain = 1.0f;
+
+    float* serial = NULL;
+    float* parallel = NULL;
+    int serial_count = 0;
+    int parallel_count = 0;
+
+    // black and white stripes, the smallest and the largest radii side by side
+    unsigned char stripes[64 * 64];
+    for (int p = 0; p < 64 * 64; p++) stripes[p] = p % 64 / 8 % 2 ? 255 : 0;
+    image_t density = { stripes, 64, 64, GL_RED };
+
+    for (int variant = 0; variant < 3 && !last_status; variant++)
+    {
+        const image_t* image = variant == 2 ? &density : NULL;
+        int tiled = variant > 0;
+
+        CHECK_CALL_GOTO_ERROR(sample_poisson, cleanup, radius, domain, image, tiled, 1, &serial, &serial_count);
+        CHECK_CALL_GOTO_ERROR(check_poisson_spacing, cleanup, serial, serial_count);
+
+        if (tiled)
+        {
+            CHECK_CALL_GOTO_ERROR(sample_poisson, cleanup, radius, domain, image, tiled, POISSON_THREADS, &parallel, &parallel_count);
+            if (parallel_count != serial_count || memcmp(parallel, serial, (size_t)serial_count * 3 * sizeof(float)))
+            {
+                fprintf(stderr, "Tiled sampling gave %d points on %d threads and %d on one\n", parallel_count, POISSON_THREADS, serial_count);
+                last_status = PG_FAIL;
+            }
+        }
+
+        free(serial);
+        free(parallel);
+        serial = NULL;
+        parallel = NULL;
+    }
+
+cleanup:
+    free(serial);
+    free(parallel);
+    return last_status;
+}
+
+// The wavefront must give what a scan in order gives, down to the last pixel, and
+// leave the alpha of gray and alpha or RGBA images as it was.
+// Widths below the lag between two rows leave every row waiting on the whole row above.
+static int test_error_diffusion(void)
+{
+    int last_status = PG_SUCCESS;
+    const int sizes[][2] = { { 1, 1 }, { 3, 7 }, { 4, 33 }, { 5, 2 }, { 17, 9 }, { 64, 31 }, { 203, 65 }, { 1021, 257 } };
+    const int levels[] = { 2, 3, 8 };
+
+    uint32_t seed = TEST_SEED;
+    int variant = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && !last_status; s++)
+    {
+        for (int kernel = DIFFUSION_FLOYD_STEINBERG; kernel <= DIFFUSION_ATKINSON && !last_status; kernel++, variant++)
+        {
+            int width = sizes[s][0];
+            int height = sizes[s][1];
+            // every kernel meets every channel count over the sizes
+            int channels = 1 + (variant + (int)s) % 4;
+            int level_count = levels[variant % 3];
+            size_t bytes = (size_t)width * height * channels;
+
+            uint8_t* wavefront = (uint8_t*)malloc(bytes);
+            uint8_t* serial = (uint8_t*)malloc(bytes);
+            uint8_t* source = (uint8_t*)malloc(bytes);
+            if (!wavefront || !serial || !source)
+            {
+                free(wavefront);
+                free(serial);
+                free(source);
+                return PG_ALLOCATION_ERROR;
+            }
+
+            for (size_t b = 0; b < bytes; b++) source[b] = (uint8_t)(random_float(&seed) * 255.0f);
+            memcpy(wavefront, source, bytes);
+            memcpy(serial, source, bytes);
+
+            last_status = diffuse_error(wavefront, width, height, channels, level_count, kernel);
+            if (!last_status) last_status = diffuse_error_serial(serial, width, height, channels, level_count, kernel);
+            if (!last_status && memcmp(wavefront, serial, bytes))
+            {
+                fprintf(stderr, "%dx%d image with %d channels and %d levels: kernel %d differs from the serial scan\n",
+                    width, height, channels, level_count, kernel);
+                last_status = PG_FAIL;
+            }
+            for (size_t b = channels - 1; b < bytes && !last_status && channels % 2 == 0; b += channels)
+            {
+                if (wavefront[b] != source[b])
+                {
+                    fprintf(stderr, "%dx%d image with %d channels: alpha changed by kernel %d\n", width, height, channels, kernel);
+                    last_status = PG_FAIL;
+                }
+            }
+
+            free(wavefront);
+            free(serial);
+            free(source);
+        }
+    }
+
+    return last_status;
+}
+
+// Closest pair of the darkest pixels, within the tile and across its edges
+static void closest_pairs(const uint8_t* mask, int size, int threshold, int* inside, int* across)
+{
+    const int reach = 4;
+    *inside = 2 * reach * reach + 1;
+    *across = *inside;
+
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            if (mask[y * size + x] >= threshold) continue;
+            for (int dy = -reach; dy <= reach; dy++)
+            {
+                for (int dx = -reach; dx <= reach; dx++)
+                {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    int wrapped = nx < 0 || ny < 0 || nx >= size || ny >= size;
+                    nx = (nx + size) % size;
+                    ny = (ny + size) % size;
+                    if ((!dx && !dy) || mask[ny * size + nx] >= threshold) continue;
+
+                    int d = dx * dx + dy * dy;
+                    int* closest = wrapped ? across : inside;
+                    if (d < *closest) *closest = d;
+                }
+            }
+        }
+    }
+}
+
+// Every threshold must be equally represented, the mask tiles without seams,
+// and thresholded patterns keep far less low frequency energy than white noise
+static int test_blue_noise(void)
+{
+    int last_status = PG_SUCCESS;
+    const int size = 64;
+    uint8_t* mask = NULL;
+
+    CHECK_CALL(generate_blue_noise, size, &mask);
+
+    int histogram[256] = { 0 };
+    for (int p = 0; p < size * size; p++) histogram[mask[p]]++;
+    for (int v = 0; v < 256 && !last_status; v++)
+    {
+        if (histogram[v] != size * size / 256)
+        {
+            fprintf(stderr, "Threshold %d covers %d pixels instead of %d\n", v, histogram[v], size * size / 256);
+            last_status = PG_FAIL;
+        }
+    }
+
+    for (int threshold = 16; threshold <= 32 && !last_status; threshold *= 2)
+    {
+        int inside = 0;
+        int across = 0;
+        closest_pairs(mask, size, threshold, &inside, &across);
+        if (across < inside)
+        {
+            fprintf(stderr, "Threshold %d: pixels %d apart across the edges, %d inside\n", threshold, across, inside);
+            last_status = PG_FAIL;
+        }
+    }
+
+    // white noise spreads p(1-p) per pixel evenly over every frequency
+    const int low = size / 8;
+    for (int threshold = 32; threshold <= 128 && !last_status; threshold *= 2)
+    {
+        double p = threshold / 256.0;
+        double energy = 0.0;
+        int frequencies = 0;
+        for (int ky = -low; ky <= low; ky++)
+        {
+            for (int kx = -low; kx <= low; kx++)
+            {
+                if ((!kx && !ky) || kx * kx + ky * ky > low * low) continue;
+
+                double re = 0.0;
+                double im = 0.0;
+                for (int y = 0; y < size; y++)
+                {
+                    for (int x = 0; x < size; x++)
+                    {
+                        double value = (mask[y * size + x] < threshold) - p;
+                        double angle = 2.0 * M_PI * (kx * x + ky * y) / size;
+                        re += value * cos(angle);
+                        im -= value * sin(angle);
+                    }
+                }
+                energy += re * re + im * im;
+                frequencies++;
+            }
+        }
+
+        double ratio = energy / frequencies / (size * size * p * (1.0 - p));
+        if (ratio > 0.25)
+        {
+            fprintf(stderr, "Threshold %d: low frequencies hold %.2f of the energy of white noise\n", threshold, ratio);
+            last_status = PG_FAIL;
+        }
+    }
+
+    free(mask);
+    return last_status;
+}
+
+// An image with no more colors than the palette keeps them, every pixel its own
+static int test_palette_exact(void)
+{
+    int last_status = PG_SUCCESS;
+    const int count = 5000;
+    const int distinct = 37;
+
+    uint8_t colors[3 * 37];
+    uint8_t pixels[3 * 5000];
+    uint8_t palette[3 * PALETTE_MAX_COLORS];
+    uint8_t indices[5000];
+
+    uint32_t seed = TEST_SEED;
+    for (int c = 0; c < 3 * distinct; c++) colors[c] = (uint8_t)(random_float(&seed) * 256.0f);
+    for (int p = 0; p < count; p++) memcpy(pixels + 3 * p, colors + 3 * (p % distinct), 3);
+
+    for (int size = distinct; size <= 2 * distinct && !last_status; size += distinct)
+    {
+        int palette_size = 0;
+        CHECK_CALL(quantize_palette, pixels, count, size, 0, palette, &palette_size, indices);
+
+        if (palette_size != distinct)
+        {
+            fprintf(stderr, "%d entries for an image of %d colors\n", palette_size, distinct);
+            return PG_FAIL;
+        }
+        for (int p = 0; p < count && !last_status; p++)
+        {
+            if (memcmp(palette + 3 * indices[p], pixels + 3 * p, 3))
+            {
+                fprintf(stderr, "Pixel %d is not mapped to its own color\n", p);
+                last_status = PG_FAIL;
+            }
+        }
+    }
+
+    return last_status;
+}
+
+static double palette_error(const uint8_t* pixels, int count, const uint8_t* palette, const uint8_t* indices)
+{
+    double error = 0.0;
+    for (int p = 0; p < count; p++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            double d = (double)pixels[3 * p + c] - palette[3 * indices[p] + c];
+            error += d * d;
+        }
+    }
+    return error;
+}
+
+// Every k-means iteration moves the entries to the mean of their pixels, then
+// maps the pixels to their nearest entry, neither can raise the error
+static int test_palette_refinement(void)
+{
+    int last_status = PG_SUCCESS;
+    const int width = 96;
+    const int height = 64;
+    const int count = width * height;
+
+    uint8_t* pixels = (uint8_t*)malloc(3 * (size_t)count);
+    uint8_t* indices = (uint8_t*)malloc((size_t)count);
+    uint8_t palette[3 * PALETTE_MAX_COLORS];
+    if (!pixels || !indices)
+    {
+        last_status = PG_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    // noisy gradients, thousands of colors most of them on several pixels
+    uint32_t seed = TEST_SEED;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint8_t* pixel = pixels + 3 * ((size_t)y * width + x);
+            pixel[0] = (uint8_t)(x / 3 * 255 / width);
+            pixel[1] = (uint8_t)(y / 2 * 255 / height);
+            pixel[2] = (uint8_t)((int)(random_float(&seed) * 4.0f) * 85);
+        }
+    }
+
+    for (int colors = 4; colors <= 64 && !last_status; colors *= 4)
+    {
+        double previous = 0.0;
+        for (int iterations = 0; iterations <= PALETTE_ITERATIONS; iterations++)
+        {
+            int palette_size = 0;
+            CHECK_CALL_GOTO_ERROR(fit_palette, cleanup, pixels, count, colors, 0, iterations, palette, &palette_size, indices);
+
+            double error = palette_error(pixels, count, palette, indices);
+            if (iterations && error > previous)
+            {
+                fprintf(stderr, "%d colors: error %.0f after %d iterations, %.0f before\n", colors, error, iterations, previous);
+                last_status = PG_FAIL;
+                break;
+            }
+            previous = error;
+        }
+    }
+
+cleanup:
+    free(pixels);
+    free(indices);
+    return last_status;
+}
+
+static const test_t tests[] =
+{
+    { "colonization nearest nodes", test_colonization_nearest },
+    { "poisson disk spacing", test_poisson_disk },
+    { "error diffusion wavefront", test_error_diffusion },
+    { "blue noise mask", test_blue_noise },
+    { "palette of few colors", test_palette_exact },
+    { "palette refinement", test_palette_refinement },
+};
 
 int main(void)
 {
-    printf("Hello Test\n");
-    return 0;
-}
\ No newline at end of file
+    int count = (int)(sizeof(tests) / sizeof(tests[0]));
+    int failed = 0;
+
+    for (int t = 0; t < count; t++)
+    {
+        int status = tests[t].run();
+        printf("[%s] %s\n", status ? "FAIL" : " OK ", tests[t].name);
+        if (status) failed++;
+    }
+
+    printf("[>] %d of %d tests passed\n", count - failed, count);
+    return failed ? 1 : 0;
+}